@@ -0,0 +1,304 @@
+/**
+    @file   game.c
+    @author Vince Alain W. Verwilligen (vav18), Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  The rules of the tetris game, independent of the board's inputs and outputs.
+*/
+
+#include "game.h"
+
+/** The gravity of a level, the falling tetromino drops cells pixels every ticks game ticks. */
+typedef struct {
+    uint8_t cells;
+    uint8_t ticks;
+} game_gravity_t;
+
+/**
+    The gravity of each level. Up to level 10 it drops a pixel every 100 ticks, 10 fewer each level,
+    then it drops more pixels each tick up to 20, which takes any tetromino straight down. The levels
+    past the end of the table keep its last gravity.
+*/
+static const game_gravity_t game_gravities[] = {
+    { 1, 100 }, { 1, 90 }, { 1, 80 }, { 1, 70 }, { 1, 60 }, { 1, 50 }, { 1, 40 }, { 1, 30 },
+    { 1, 20 }, { 1, 10 }, { 1, 1 }, { 2, 1 }, { 3, 1 }, { 5, 1 }, { 10, 1 }, { 20, 1 }
+};
+
+
+/** Creates a game waiting to be initialised, the seed and mode set the randomizer that picks the tetrominos. The handling is the default one. */
+game_data_t game_create(uint32_t seed, randomizer_mode_t mode)
+{
+    game_data_t game_data = {
+        .state = STATE_INIT,
+        .tetrion = tetrion_create(),
+        .seed = seed,
+        .handling = { .das = GAME_DAS_TICKS, .arr = GAME_ARR_TICKS, .soft_drop = GAME_SOFT_DROP_TICKS, .line_clear = GAME_LINE_CLEAR_TICKS },
+        .recorder = NULL
+    };
+
+    game_data.tetrion.randomizer = randomizer_create(seed, mode);
+
+    return game_data;
+}
+
+
+/** Starts the randomizer over from the seed, clears the tetrion, adds the first tetromino and sets the game to playing. */
+void game_start(game_data_t* game_data)
+{
+    replay_header_t header = {
+        .width = TETRION_WIDTH,
+        .height = TETRION_HEIGHT,
+        .mode = game_data->tetrion.randomizer.mode,
+        .seed = game_data->seed,
+        .das = game_data->handling.das,
+        .arr = game_data->handling.arr,
+        .soft_drop = game_data->handling.soft_drop,
+        .line_clear = game_data->handling.line_clear
+    };
+
+    randomizer_seed(&game_data->tetrion.randomizer, game_data->seed);
+    tetrion_clear(&game_data->tetrion);
+    tetrion_try_add_tetromino(&game_data->tetrion);
+    game_data->gravity = 0;
+    game_data->shift = GAME_INPUT_NONE;
+    game_data->shift_ticks = 0;
+    game_data->soft_drop_ticks = 0;
+    game_data->clearing_lines = 0;
+    game_data->clear_ticks = 0;
+    game_data->state = STATE_PLAYING;
+
+    if (game_data->recorder) {
+        replay_record_start(game_data->recorder, game_data->ticks, &header);
+    }
+}
+
+
+/** Returns the level of the game, which goes up every LINES_PER_LEVEL lines. */
+uint8_t game_level(game_data_t* game_data)
+{
+    return game_data->tetrion.lines / LINES_PER_LEVEL;
+}
+
+
+/**
+ * Removes the full lines and shows a new tetromino.
+ * If the new tetromino is shown on an already existing tetromino, the game is over.
+ */
+static game_event_t game_clear(game_data_t* game_data)
+{
+    game_event_t events = GAME_EVENT_NONE;
+
+    if (tetrion_check_lines(&game_data->tetrion)) {
+        events |= GAME_EVENT_CLEARED;
+    }
+    game_data->clearing_lines = 0;
+    game_data->state = STATE_PLAYING;
+
+    if (!tetrion_try_add_tetromino(&game_data->tetrion)) {
+        game_data->state = STATE_OVER;
+        events |= GAME_EVENT_OVER;
+    }
+
+    return events;
+}
+
+
+/**
+ * Is called once the falling tetromino hit bottom, it sticks and a new tetromino will be shown.
+ * When it makes full lines and the handling has a line clear, the game clears them first, showing
+ * them for the line clear ticks before game_clear removes them.
+ */
+static game_event_t game_lock(game_data_t* game_data)
+{
+    game_event_t events = GAME_EVENT_LOCKED;
+
+    tetrion_lock_tetromino(&game_data->tetrion);
+    game_data->clearing_lines = tetrion_full_lines(&game_data->tetrion);
+    if (game_data->clearing_lines) {
+        events |= GAME_EVENT_LINES;
+
+        if (game_data->handling.line_clear > 0) {
+            game_data->clear_ticks = game_data->handling.line_clear;
+            game_data->state = STATE_CLEARING;
+            return events;
+        }
+    }
+
+    return events | game_clear(game_data);
+}
+
+
+/**
+ * Is called every time the falling tetromino is going to fall, by cells pixels.
+ * It falls as far as it can at once, found from the tetrion's skyline rather than trying each pixel.
+ * Once the falling tetromino rests on the bottom or on another, the next drop locks it by game_lock.
+ */
+static game_event_t game_drop(game_data_t* game_data, uint8_t cells)
+{
+    uint8_t distance = tetrion_drop_distance(&game_data->tetrion);
+
+    if (distance == 0) {
+        return game_lock(game_data);
+    }
+
+    game_data->tetrion.current_tetromino.position.y += cells < distance ? cells : distance;
+
+    return GAME_EVENT_NONE;
+}
+
+
+/** Moves the falling tetromino one pixel the way of the last pushed of left and right, returns false if it cannot. */
+static bool game_shift(game_data_t* game_data)
+{
+    if (game_data->shift == GAME_INPUT_LEFT) {
+        return tetrion_try_move_left(&game_data->tetrion);
+    }
+
+    return tetrion_try_move_right(&game_data->tetrion);
+}
+
+
+/** Repeats the shift of a held left or right when its ticks have counted down, as far as it goes when the repeat rate is 0. */
+static void game_auto_shift(game_data_t* game_data)
+{
+    if (game_data->shift_ticks > 0 && --game_data->shift_ticks > 0) {
+        return;
+    }
+
+    if (game_data->handling.arr == 0) {
+        while (game_shift(game_data))
+            continue;
+    } else {
+        game_shift(game_data);
+        game_data->shift_ticks = game_data->handling.arr;
+    }
+}
+
+
+/** Repeats the move down of a held down when its ticks have counted down, as far as it goes when the soft drop is 0. */
+static void game_soft_drop(game_data_t* game_data)
+{
+    if (game_data->soft_drop_ticks > 0 && --game_data->soft_drop_ticks > 0) {
+        return;
+    }
+
+    if (game_data->handling.soft_drop == 0) {
+        tetrion_hard_drop(&game_data->tetrion);
+    } else {
+        tetrion_try_move_down(&game_data->tetrion);
+        game_data->soft_drop_ticks = game_data->handling.soft_drop;
+    }
+}
+
+
+/**
+    Applies the pushed buttons to the falling tetromino, in the order the input tasks read them.
+    A held button repeats its move in the place of its push, and a push starts its repeats over.
+    A hard drop comes last, it moves the tetromino straight to where it lands and locks it there.
+*/
+static game_event_t game_apply_input(game_data_t* game_data, game_input_t input)
+{
+    if (input & GAME_INPUT_ROTATE_CLOCKWISE) {
+        tetrion_try_rotate_clockwise(&game_data->tetrion);
+    }
+
+    if (input & GAME_INPUT_DOWN) {
+        tetrion_try_move_down(&game_data->tetrion);
+        game_data->soft_drop_ticks = game_data->handling.soft_drop;
+    } else if (input & GAME_INPUT_HOLD_DOWN) {
+        game_soft_drop(game_data);
+    }
+
+    if (input & GAME_INPUT_LEFT) {
+        tetrion_try_move_left(&game_data->tetrion);
+        game_data->shift = GAME_INPUT_LEFT;
+        game_data->shift_ticks = game_data->handling.das;
+    }
+
+    if (input & GAME_INPUT_RIGHT) {
+        tetrion_try_move_right(&game_data->tetrion);
+        game_data->shift = GAME_INPUT_RIGHT;
+        game_data->shift_ticks = game_data->handling.das;
+    }
+
+    if (!(input & (GAME_INPUT_LEFT | GAME_INPUT_RIGHT)) && (input & GAME_INPUT_HOLD_SHIFT) && game_data->shift != GAME_INPUT_NONE) {
+        game_auto_shift(game_data);
+    }
+
+    if (input & GAME_INPUT_ROTATE_COUNTERCLOCKWISE) {
+        tetrion_try_rotate_counterclockwise(&game_data->tetrion);
+    }
+
+    if (input & GAME_INPUT_HARD_DROP) {
+        tetrion_hard_drop(&game_data->tetrion);
+        game_data->gravity = 0;
+        return game_lock(game_data);
+    }
+
+    return GAME_EVENT_NONE;
+}
+
+
+/**
+    Plays a step of a game that is playing: the pushed buttons are recorded and applied to the falling
+    tetromino, then the gravity of the level is added up, and the whole pixels of it are dropped.
+*/
+static game_event_t game_play(game_data_t* game_data, game_input_t input)
+{
+    game_event_t events;
+    const game_gravity_t* gravity;
+    uint8_t level = game_level(game_data);
+    uint8_t cells;
+
+    if (game_data->recorder) {
+        replay_record_input(game_data->recorder, game_data->ticks, input);
+    }
+
+    events = game_apply_input(game_data, input);
+
+    gravity = &game_gravities[level < ARRAY_SIZE(game_gravities) ? level : ARRAY_SIZE(game_gravities) - 1];
+    if (game_data->state == STATE_PLAYING) {
+        // a faster level keeps the drop that was coming, rather than dropping the ticks it has gained all at once
+        if (game_data->gravity >= gravity->ticks) {
+            game_data->gravity = gravity->ticks - 1;
+        }
+
+        game_data->gravity += gravity->cells;
+        cells = game_data->gravity / gravity->ticks;
+        game_data->gravity %= gravity->ticks;
+
+        if (cells) {
+            events |= game_drop(game_data, cells);
+        }
+    }
+
+    return events;
+}
+
+
+/**
+    Advances the game by one tick of GAME_TICK_RATE. The pushed buttons are applied to the falling
+    tetromino first, then it drops if its time has come. While clearing, the buttons are ignored and
+    the step counts down to the removal of the full lines. Returns the events of the step.
+    While playing, the buttons are recorded if the game has a recorder, and the recording ends with the game.
+*/
+game_event_t game_step(game_data_t* game_data, game_input_t input)
+{
+    game_event_t events = GAME_EVENT_NONE;
+
+    game_data->ticks++;
+
+    if (game_data->state == STATE_CLEARING) {
+        // the new tetromino appears at the end of the last clearing step, the buttons wait for the next
+        if (--game_data->clear_ticks == 0) {
+            events = game_clear(game_data);
+        }
+    } else if (game_data->state == STATE_PLAYING) {
+        events = game_play(game_data, input);
+    }
+
+    if (events & GAME_EVENT_OVER && game_data->recorder) {
+        replay_record_end(game_data->recorder, game_data->ticks, tetrion_hash(&game_data->tetrion));
+    }
+
+    return events;
+}
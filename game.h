@@ -0,0 +1,144 @@
+/**
+    @file   game.h
+    @author Vince Alain W. Verwilligen (vav18), Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  The rules of the tetris game, independent of the board's inputs and outputs.
+*/
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "replay.h"
+#include "tetrion.h"
+
+#define MESSAGE_SIZE 50
+
+#define GAME_TICK_RATE 100
+#define LINES_PER_LEVEL 10
+
+/**
+    Inputs given to game_step, a bitmask of the buttons pushed since the previous step. Each push
+    moves the falling tetromino once. The hold bits say that a button pushed at an earlier step is
+    still held: HOLD_SHIFT the one of left and right pushed last, HOLD_DOWN down. They repeat its
+    move as the game's handling sets.
+*/
+typedef uint8_t game_input_t;
+
+#define GAME_INPUT_NONE 0
+#define GAME_INPUT_ROTATE_CLOCKWISE BIT(0)
+#define GAME_INPUT_DOWN BIT(1)
+#define GAME_INPUT_LEFT BIT(2)
+#define GAME_INPUT_RIGHT BIT(3)
+#define GAME_INPUT_ROTATE_COUNTERCLOCKWISE BIT(4)
+#define GAME_INPUT_HARD_DROP BIT(5)
+#define GAME_INPUT_HOLD_SHIFT BIT(6)
+#define GAME_INPUT_HOLD_DOWN BIT(7)
+
+/** The pushes that repeat while their button is held. */
+#define GAME_INPUT_REPEATING (GAME_INPUT_DOWN | GAME_INPUT_LEFT | GAME_INPUT_RIGHT)
+
+/** The handling the game is created with, in game ticks. */
+#define GAME_DAS_TICKS 17
+#define GAME_ARR_TICKS 3
+#define GAME_SOFT_DROP_TICKS 3
+#define GAME_LINE_CLEAR_TICKS 24
+
+/**
+    How held buttons repeat their moves, in game ticks, so a replay of the same inputs repeats them
+    the same way.
+     - The delayed auto shift is the ticks from pushing left or right to the first repeat of the move.
+     - The auto repeat rate is the ticks between the repeats after that, 0 moves it as far as it goes each tick.
+     - The soft drop is the ticks between the repeats of down, 0 moves it as far down as it goes each tick.
+     - The line clear is the ticks full lines stay on the tetrion before they are removed, 0 removes them at once.
+*/
+typedef struct {
+    uint8_t das;
+    uint8_t arr;
+    uint8_t soft_drop;
+    uint8_t line_clear;
+} game_handling_t;
+
+/**
+    Events returned by game_step, a bitmask of what happened during the step. LINES comes when a
+    locked tetromino makes full lines and CLEARED when they are removed, at the same step when the
+    line clear is 0.
+*/
+typedef uint8_t game_event_t;
+
+#define GAME_EVENT_NONE 0
+#define GAME_EVENT_LOCKED BIT(0)
+#define GAME_EVENT_LINES BIT(1)
+#define GAME_EVENT_OVER BIT(2)
+#define GAME_EVENT_CLEARED BIT(3)
+
+/**
+    All the possible states the Tetris game can be in.
+     - STATE_INIT = when the program is first run used to initialise variables and setup the game for use.
+     - STATE_READY = when the game is initialised, waiting for the used to push button to start.
+     - STATE_PLAYING =  the main state of a tetris game from when a game is started up until tiles can no longer be placed.
+     - STATE_CLEARING = the full lines made by the last tile are shown for the line clear ticks before they are removed and
+       the next tile appears, the game steps taking no input meanwhile. The game then goes back to STATE_PLAYING, or to STATE_OVER.
+     - STATE_OVER = the game over message shown after a tile can no longer be placed. This displays the score the player got. 
+*/
+typedef enum { 
+    STATE_INIT,
+    STATE_READY,
+    STATE_PLAYING,
+    STATE_CLEARING,
+    STATE_OVER
+} state_t;
+
+/** 
+Game data type used to score the current state of the tetris game. All state of a game lives here, so any number of games can run side by side.
+     - The state refers to the games current situation eg. STATE_OVER when the game has been lost and the score is being displayed. 
+     - The tetrion refers to the board for the current game and stores a tetrion_t type which also stores the current tetromino.
+     - The seed starts the randomizer over at the start of each game, so a game is decided by its seed and inputs.
+     - The ticks count every step since the game was created, playing or not.
+     - The gravity adds up the level's gravity each step, the pixels the falling tetromino has yet to
+       drop, in steps of 1 / ticks of a pixel for a level that drops cells pixels every ticks steps.
+     - The handling sets how held buttons repeat. The shift is the one of left and right pushed last,
+       and the shift and soft drop ticks count down to the next repeat of their moves.
+     - The held buttons are the repeating buttons the board's input sees held down, and the held shift
+       is the one of left and right pushed last of them. They are cleared when a game is started, so a
+       new game never repeats a push from the last one.
+     - The clearing lines are the full lines shown while clearing, and the clear ticks count down to their removal.
+     - The message refers to the message displayed. eg. "Push button to start" when the game is just started.
+     - The recorder, when not NULL, records a replay of each game.
+*/
+typedef struct
+{
+    state_t state;
+    tetrion_t tetrion;
+    uint32_t seed;
+    uint32_t ticks;
+    uint8_t gravity;
+    game_handling_t handling;
+    game_input_t shift;
+    uint8_t shift_ticks;
+    uint8_t soft_drop_ticks;
+    game_input_t held;
+    game_input_t held_shift;
+    tetrion_line_mask_t clearing_lines;
+    uint8_t clear_ticks;
+    char message[MESSAGE_SIZE];
+    replay_recorder_t* recorder;
+} game_data_t;
+
+/** Creates a game waiting to be initialised, the seed and mode set the randomizer that picks the tetrominos. The handling is the default one. */
+game_data_t game_create(uint32_t seed, randomizer_mode_t mode);
+
+/** Starts the randomizer over from the seed, clears the tetrion, adds the first tetromino and sets the game to playing. */
+void game_start(game_data_t* game_data);
+
+/** Returns the level of the game, which goes up every LINES_PER_LEVEL lines. */
+uint8_t game_level(game_data_t* game_data);
+
+/**
+    Advances the game by one tick of GAME_TICK_RATE. The pushed buttons are applied to the falling
+    tetromino first, then it drops if its time has come. While clearing, the buttons are ignored and
+    the step counts down to the removal of the full lines. Returns the events of the step.
+    While playing, the buttons are recorded if the game has a recorder, and the recording ends with the game.
+*/
+game_event_t game_step(game_data_t* game_data, game_input_t input);
+
+#endif // GAME_H
@@ -0,0 +1,83 @@
+/**
+    @file   hal.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  The hardware the game uses beyond the UCFK4 drivers.
+
+    Each function has two versions, hal_avr.c for the board and host/hal_host.c for the host build,
+    so the game sources call the same API on both.
+*/
+
+#ifndef HAL_H
+#define HAL_H
+
+#include "system.h"
+#include "timer.h"
+
+/**
+    The rate the cycle counter counts at. On the board it counts CPU cycles, 8 at a time, from
+    timer/counter 0. On the host it counts nanoseconds of the monotonic clock.
+*/
+#ifdef __AVR__
+#define HAL_CYCLE_RATE F_CPU
+#else
+#define HAL_CYCLE_RATE 1000000000UL
+#endif
+
+/** Starts the cycle counter. */
+void hal_cycles_init(void);
+
+/** Returns the cycle counter, which wraps around at 32 bits, so only differences of it are useful. */
+uint32_t hal_cycles(void);
+
+/** An interrupt handler, called with the other interrupts off, so it must be short. */
+typedef void (*hal_interrupt_t)(void);
+
+/**
+    Calls handler rate times a second from a timer interrupt, so it runs on time whatever the tasks
+    are doing. On the board the interrupt is timer/counter 0's compare match A, moved on by a
+    period at each match while the counter keeps running freely for the cycle counter, so rate must
+    be at least F_CPU / 8 / 256. On the host it is the stand-in timer's interrupt on the virtual clock.
+*/
+void hal_audio_start(uint16_t rate, hal_interrupt_t handler);
+
+/**
+    Returns the number of audio interrupts so far and the largest time from an interrupt coming due
+    to its handler being called, in cycles of the cycle counter.
+*/
+uint32_t hal_audio_stats(uint32_t* late_max);
+
+/**
+    Calls handler rate times a second from a timer interrupt, to sample the inputs. On the board the
+    interrupt is timer/counter 0's compare match B, which comes every 200 counts and calls handler
+    on every few, so rate must divide F_CPU / 8 / 200. On the host it is the stand-in timer's second
+    interrupt.
+*/
+void hal_input_start(uint16_t rate, hal_interrupt_t handler);
+
+/** Turns the interrupts off and returns the state to restore, to change data an interrupt handler also uses. */
+uint8_t hal_interrupts_disable(void);
+
+/** Turns the interrupts back on if they were on before the matching hal_interrupts_disable. */
+void hal_interrupts_restore(uint8_t state);
+
+/** A task function, as the scheduler runs it. */
+typedef void (*hal_task_t)(void* data);
+
+/**
+    Sleeps until the timer reaches when, or returns at once if it is already past. On the board
+    the CPU idles until timer/counter 1's compare match A, waking up on the way for every other
+    interrupt. On the host the virtual clock moves on to when.
+*/
+void hal_sleep_until(timer_tick_t when);
+
+/** Runs a task. On the host, the task's time is also taken off the virtual clock when TETRIS_HOST_CPU_SCALE is set. */
+void hal_task_run(hal_task_t func, void* data);
+
+/** Returns the seconds the scheduler runs for, zero for ever. The board runs for ever, the host for TETRIS_HOST_SECONDS. */
+uint16_t hal_run_seconds(void);
+
+/** Writes a line of text to the console. The board has none, so there the line is dropped. */
+void hal_console_write(const char* line);
+
+#endif
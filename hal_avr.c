@@ -0,0 +1,226 @@
+/**
+    @file   hal_avr.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  The hardware the game uses beyond the UCFK4 drivers, on the ATmega32u2.
+*/
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include "hal.h"
+
+/** Timer/counter 0 counts every 8 CPU cycles, and its overflows are counted to make it 32 bits wide. */
+#define HAL_CYCLES_PRESCALE_SHIFT 3
+
+#define HAL_TIMER0_RATE (F_CPU >> HAL_CYCLES_PRESCALE_SHIFT)
+
+/** Timer/counter 0 is 8 bits wide, so compare match B comes at a fixed rate and the input handler is called on every few. */
+#define HAL_INPUT_PERIOD 200
+
+static volatile uint32_t hal_overflows;
+
+static hal_interrupt_t hal_audio_handler;
+static uint8_t hal_audio_period;
+static volatile uint32_t hal_audio_calls;
+static volatile uint8_t hal_audio_late_max;
+
+static hal_interrupt_t hal_input_handler;
+static uint8_t hal_input_divider;
+static uint8_t hal_input_count;
+
+
+ISR(TIMER0_OVF_vect)
+{
+    hal_overflows++;
+}
+
+
+/**
+    Moves the compare match on by a period, from when it was due rather than from now, so a late
+    call does not put off the ones after it, then calls the audio handler.
+*/
+ISR(TIMER0_COMPA_vect)
+{
+    uint8_t late = TCNT0 - OCR0A;
+
+    OCR0A += hal_audio_period;
+
+    if (late > hal_audio_late_max) {
+        hal_audio_late_max = late;
+    }
+    hal_audio_calls++;
+
+    hal_audio_handler();
+}
+
+
+/** Moves compare match B on by a period and calls the input handler on every hal_input_divider matches. */
+ISR(TIMER0_COMPB_vect)
+{
+    OCR0B += HAL_INPUT_PERIOD;
+
+    if (++hal_input_count >= hal_input_divider) {
+        hal_input_count = 0;
+        hal_input_handler();
+    }
+}
+
+
+/** Does nothing but wake the CPU up from hal_sleep_until. */
+EMPTY_INTERRUPT(TIMER1_COMPA_vect);
+
+
+/** Starts timer/counter 0 running freely at F_CPU / 8, unless it is already running. */
+static void hal_timer0_init(void)
+{
+    if (TCCR0B == BIT(CS01)) {
+        return;
+    }
+
+    TCCR0A = 0;
+    TCCR0B = BIT(CS01);
+    TCNT0 = 0;
+}
+
+
+/** Starts the cycle counter, timer/counter 0 running freely at F_CPU / 8 with its overflow interrupt on. */
+void hal_cycles_init(void)
+{
+    hal_timer0_init();
+    TIFR0 = BIT(TOV0);
+    TIMSK0 |= BIT(TOIE0);
+    sei();
+}
+
+
+/**
+    Returns the cycle counter, which wraps around at 32 bits, so only differences of it are useful.
+    An overflow not yet counted by the interrupt is counted here, so the counter never steps back.
+*/
+uint32_t hal_cycles(void)
+{
+    uint32_t overflows;
+    uint8_t count;
+    uint8_t sreg;
+
+    sreg = SREG;
+    cli();
+
+    count = TCNT0;
+    overflows = hal_overflows;
+    if ((TIFR0 & BIT(TOV0)) && count != UINT8_MAX) {
+        overflows++;
+    }
+
+    SREG = sreg;
+
+    return ((overflows << 8) | count) << HAL_CYCLES_PRESCALE_SHIFT;
+}
+
+
+/** Calls handler rate times a second from timer/counter 0's compare match A interrupt. */
+void hal_audio_start(uint16_t rate, hal_interrupt_t handler)
+{
+    hal_timer0_init();
+
+    hal_audio_handler = handler;
+    hal_audio_period = HAL_TIMER0_RATE / rate;
+    OCR0A = TCNT0 + hal_audio_period;
+    TIFR0 = BIT(OCF0A);
+    TIMSK0 |= BIT(OCIE0A);
+    sei();
+}
+
+
+/** Calls handler rate times a second from timer/counter 0's compare match B interrupt. */
+void hal_input_start(uint16_t rate, hal_interrupt_t handler)
+{
+    hal_timer0_init();
+
+    hal_input_handler = handler;
+    hal_input_divider = HAL_TIMER0_RATE / HAL_INPUT_PERIOD / rate;
+    hal_input_count = 0;
+    OCR0B = TCNT0 + HAL_INPUT_PERIOD;
+    TIFR0 = BIT(OCF0B);
+    TIMSK0 |= BIT(OCIE0B);
+    sei();
+}
+
+
+/** Returns the number of audio interrupts so far and the largest time from an interrupt coming due to its handler being called, in CPU cycles. */
+uint32_t hal_audio_stats(uint32_t* late_max)
+{
+    uint32_t calls;
+    uint8_t state;
+
+    state = hal_interrupts_disable();
+    calls = hal_audio_calls;
+    *late_max = (uint32_t) hal_audio_late_max << HAL_CYCLES_PRESCALE_SHIFT;
+    hal_interrupts_restore(state);
+
+    return calls;
+}
+
+
+/** Turns the interrupts off and returns the status register to restore. */
+uint8_t hal_interrupts_disable(void)
+{
+    uint8_t sreg = SREG;
+
+    cli();
+
+    return sreg;
+}
+
+
+/** Puts back the status register, with it the interrupt enable bit. */
+void hal_interrupts_restore(uint8_t state)
+{
+    SREG = state;
+}
+
+
+/**
+    Idles the CPU until timer/counter 1, which the UCFK4 timer counts on, reaches when. Interrupts
+    are turned on by the instruction before sleeping, so one that comes in between still wakes it.
+*/
+void hal_sleep_until(timer_tick_t when)
+{
+    OCR1A = when;
+    TIFR1 = BIT(OCF1A);
+    TIMSK1 |= BIT(OCIE1A);
+    set_sleep_mode(SLEEP_MODE_IDLE);
+
+    cli();
+    while ((int16_t) (when - timer_get()) > 0) {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    sei();
+
+    TIMSK1 &= ~BIT(OCIE1A);
+}
+
+
+/** Runs a task. */
+void hal_task_run(hal_task_t func, void* data)
+{
+    func(data);
+}
+
+
+/** The board runs for ever. */
+uint16_t hal_run_seconds(void)
+{
+    return 0;
+}
+
+
+/** Writes a line of text to the console. The board has none, so the line is dropped. */
+void hal_console_write(__unused__ const char* line)
+{
+}
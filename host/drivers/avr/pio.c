@@ -0,0 +1,83 @@
+/**
+    @file   pio.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 PIO driver, pins are kept in memory.
+*/
+
+#include "pio.h"
+
+#define PIO_PORT_BITS 8
+
+#define PIO_PORT(PIO) ((PIO) >> 8)
+#define PIO_BIT(PIO) ((PIO) & 0xff)
+#define PIO_INDEX(PIO) (PIO_PORT(PIO) * PIO_PORT_BITS + PIO_BIT(PIO))
+
+static pio_config_t configs[PORT_COUNT * PIO_PORT_BITS];
+static bool levels[PORT_COUNT * PIO_PORT_BITS];
+static uint32_t toggles[PORT_COUNT * PIO_PORT_BITS];
+
+
+/** Configures a pin, outputs are set to their initial level. */
+bool pio_config_set(pio_t pio, pio_config_t config)
+{
+    configs[PIO_INDEX(pio)] = config;
+
+    if (config == PIO_OUTPUT_LOW) {
+        pio_output_set(pio, false);
+    } else if (config == PIO_OUTPUT_HIGH) {
+        pio_output_set(pio, true);
+    }
+
+    return true;
+}
+
+
+/** Returns the configuration of a pin. */
+pio_config_t pio_config_get(pio_t pio)
+{
+    return configs[PIO_INDEX(pio)];
+}
+
+
+/** Sets the level of an output pin. */
+void pio_output_set(pio_t pio, bool state)
+{
+    if (levels[PIO_INDEX(pio)] != state) {
+        toggles[PIO_INDEX(pio)]++;
+    }
+
+    levels[PIO_INDEX(pio)] = state;
+}
+
+
+/** Returns the level last written to a pin. */
+bool pio_output_get(pio_t pio)
+{
+    return levels[PIO_INDEX(pio)];
+}
+
+
+/** Inverts the level of an output pin. */
+void pio_output_toggle(pio_t pio)
+{
+    pio_output_set(pio, !levels[PIO_INDEX(pio)]);
+}
+
+
+/** Returns the level of a pin, inputs are always pulled high on the host. */
+bool pio_input_get(pio_t pio)
+{
+    if (configs[PIO_INDEX(pio)] == PIO_INPUT || configs[PIO_INDEX(pio)] == PIO_PULLUP) {
+        return true;
+    }
+
+    return levels[PIO_INDEX(pio)];
+}
+
+
+/** Returns the number of times a pin has changed level, used to measure the tweeter output. */
+uint32_t pio_toggle_count(pio_t pio)
+{
+    return toggles[PIO_INDEX(pio)];
+}
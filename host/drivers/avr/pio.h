@@ -0,0 +1,53 @@
+/**
+    @file   pio.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 PIO driver, pins are kept in memory.
+*/
+
+#ifndef PIO_H
+#define PIO_H
+
+#include "system.h"
+
+typedef enum {
+    PORT_B,
+    PORT_C,
+    PORT_D,
+    PORT_COUNT
+} pio_port_t;
+
+/** A pin is stored as its port in the high byte and its bit in the low byte. */
+typedef uint16_t pio_t;
+
+#define PIO_DEFINE(PORT, PORTBIT) ((pio_t) (((PORT) << 8) | (PORTBIT)))
+
+typedef enum {
+    PIO_INPUT = 1,
+    PIO_PULLUP,
+    PIO_OUTPUT_LOW,
+    PIO_OUTPUT_HIGH
+} pio_config_t;
+
+/** Configures a pin, outputs are set to their initial level. */
+bool pio_config_set(pio_t pio, pio_config_t config);
+
+/** Returns the configuration of a pin. */
+pio_config_t pio_config_get(pio_t pio);
+
+/** Sets the level of an output pin. */
+void pio_output_set(pio_t pio, bool state);
+
+/** Returns the level last written to a pin. */
+bool pio_output_get(pio_t pio);
+
+/** Inverts the level of an output pin. */
+void pio_output_toggle(pio_t pio);
+
+/** Returns the level of a pin, inputs are always pulled high on the host. */
+bool pio_input_get(pio_t pio);
+
+/** Returns the number of times a pin has changed level, used to measure the tweeter output. */
+uint32_t pio_toggle_count(pio_t pio);
+
+#endif
@@ -0,0 +1,14 @@
+/**
+    @file   system.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 system definitions.
+*/
+
+#include "system.h"
+
+
+/** Nothing to set up on the host, kept so the game sources call the same API. */
+void system_init(void)
+{
+}
@@ -0,0 +1,23 @@
+/**
+    @file   system.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 system definitions.
+*/
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define __unused__ __attribute__ ((unused))
+
+#define ARRAY_SIZE(ARRAY) (sizeof (ARRAY) / sizeof (ARRAY[0]))
+
+#define BIT(X) (1 << (X))
+
+/** Nothing to set up on the host, kept so the game sources call the same API. */
+void system_init(void);
+
+#endif
@@ -0,0 +1,159 @@
+/**
+    @file   timer.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 timer driver.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include "timer.h"
+
+/** A stand-in compare match interrupt. */
+typedef struct {
+    timer_interrupt_t handler;
+    timer_tick_t period;
+    timer_tick_t due;
+    timer_tick_t late_max;
+    uint32_t calls;
+} timer_interrupt_info_t;
+
+static timer_tick_t now;
+static uint32_t cpu_scale;
+static timer_interrupt_info_t interrupts[TIMER_INTERRUPTS];
+
+
+/** Returns the monotonic time in nanoseconds. */
+static uint64_t timer_nanoseconds(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000000ULL + time.tv_nsec;
+}
+
+
+/** Returns the virtual time nanoseconds of host time stand for. */
+static timer_tick_t timer_cpu_ticks(uint64_t nanoseconds)
+{
+    return nanoseconds * cpu_scale * TIMER_RATE / 1000000000ULL;
+}
+
+
+/** Returns the interrupt due first, no later than when, or NULL if none is. */
+static timer_interrupt_info_t* timer_interrupt_next(timer_tick_t when)
+{
+    timer_interrupt_info_t* next = NULL;
+    uint8_t i;
+
+    for (i = 0; i < TIMER_INTERRUPTS; i++) {
+        if (interrupts[i].handler == NULL || (int32_t) (when - interrupts[i].due) < 0) {
+            continue;
+        }
+        if (next == NULL || (int32_t) (interrupts[i].due - next->due) < 0) {
+            next = &interrupts[i];
+        }
+    }
+
+    return next;
+}
+
+
+/** Calls an interrupt handler, which runs to the end before anything else, so its time is taken off the clock after it. */
+static void timer_interrupt_call(timer_interrupt_info_t* interrupt)
+{
+    uint64_t start;
+
+    if (now - interrupt->due > interrupt->late_max) {
+        interrupt->late_max = now - interrupt->due;
+    }
+
+    interrupt->calls++;
+
+    start = timer_cpu_time();
+    interrupt->handler();
+    now += timer_cpu_ticks(timer_cpu_time() - start);
+
+    interrupt->due += interrupt->period;
+}
+
+
+/** Resets the virtual clock to zero, the interrupts then come due a period from zero. */
+void timer_init(void)
+{
+    const char* scale = getenv("TETRIS_HOST_CPU_SCALE");
+    uint8_t i;
+
+    cpu_scale = scale ? (uint32_t) strtoul(scale, NULL, 0) : 0;
+    now = 0;
+
+    for (i = 0; i < TIMER_INTERRUPTS; i++)
+        interrupts[i].due = interrupts[i].period;
+}
+
+
+/** Returns the current virtual time in ticks. */
+timer_tick_t timer_get(void)
+{
+    return now;
+}
+
+
+/** Moves the virtual clock forward to when, unless it is already past it, calling the interrupt handlers as they come due, and returns the time. */
+timer_tick_t timer_wait_until(timer_tick_t when)
+{
+    timer_interrupt_info_t* interrupt;
+
+    while ((interrupt = timer_interrupt_next(when)) != NULL) {
+        if ((int32_t) (interrupt->due - now) > 0) {
+            now = interrupt->due;
+        }
+        timer_interrupt_call(interrupt);
+    }
+
+    if ((int32_t) (when - now) > 0) {
+        now = when;
+    }
+
+    return now;
+}
+
+
+/** Host only: returns the host time in nanoseconds to charge code with, always zero without TETRIS_HOST_CPU_SCALE. */
+uint64_t timer_cpu_time(void)
+{
+    return cpu_scale ? timer_nanoseconds() : 0;
+}
+
+
+/** Host only: moves the virtual clock forward by the virtual time nanoseconds of host time stand for. */
+void timer_charge(uint64_t nanoseconds)
+{
+    timer_tick_t ticks = timer_cpu_ticks(nanoseconds);
+
+    if (ticks) {
+        timer_wait_until(now + ticks);
+    }
+}
+
+
+/** Host only: calls handler every period ticks from now as interrupt number interrupt, a zero period or a NULL handler stops it. */
+void timer_interrupt_set(uint8_t interrupt, timer_tick_t period, timer_interrupt_t handler)
+{
+    interrupts[interrupt].handler = period ? handler : NULL;
+    interrupts[interrupt].period = period;
+    interrupts[interrupt].due = now + period;
+    interrupts[interrupt].late_max = 0;
+    interrupts[interrupt].calls = 0;
+}
+
+
+/** Host only: returns the number of calls of an interrupt's handler and the largest lateness of a call, in ticks. */
+uint32_t timer_interrupt_stats(uint8_t interrupt, timer_tick_t* late_max)
+{
+    *late_max = interrupts[interrupt].late_max;
+
+    return interrupts[interrupt].calls;
+}
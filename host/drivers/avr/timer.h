@@ -0,0 +1,60 @@
+/**
+    @file   timer.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 timer driver.
+
+    The host timer counts virtual microseconds. Time only moves forward when
+    something waits on it, so the game runs as fast as the host allows and a
+    run is identical every time it is repeated.
+
+    The host timer also stands in for TIMER_INTERRUPTS compare match interrupts:
+    a handler set with timer_interrupt_set is called each time the virtual clock
+    passes its next due time, with the clock reading that due time, as if it had
+    cut into whatever was waiting. Interrupts due at the same time are called
+    in the order of their numbers. Each call's lateness, the time from its due
+    time to the call, is kept so the interrupt's jitter can be measured.
+
+    By default code takes no virtual time to run. With TETRIS_HOST_CPU_SCALE set
+    to how many times slower the board is than the host, the interrupt handler
+    and whatever is passed to timer_charge take their measured host time, scaled,
+    off the virtual clock. The handler cannot be cut into, so a handler that
+    runs longer than its period makes the next call late. Runs are then no
+    longer identical.
+*/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "system.h"
+
+#define TIMER_RATE 1000000
+#define TIMER_INTERRUPTS 2
+
+typedef uint32_t timer_tick_t;
+
+/** An interrupt handler. */
+typedef void (*timer_interrupt_t)(void);
+
+/** Resets the virtual clock to zero. */
+void timer_init(void);
+
+/** Returns the current virtual time in ticks. */
+timer_tick_t timer_get(void);
+
+/** Moves the virtual clock forward to when, unless it is already past it, calling the interrupt handlers as they come due, and returns the time. */
+timer_tick_t timer_wait_until(timer_tick_t when);
+
+/** Host only: calls handler every period ticks from now as interrupt number interrupt, a zero period or a NULL handler stops it. */
+void timer_interrupt_set(uint8_t interrupt, timer_tick_t period, timer_interrupt_t handler);
+
+/** Host only: returns the host time in nanoseconds to charge code with, always zero without TETRIS_HOST_CPU_SCALE. */
+uint64_t timer_cpu_time(void);
+
+/** Host only: moves the virtual clock forward by the virtual time nanoseconds of host time stand for. */
+void timer_charge(uint64_t nanoseconds);
+
+/** Host only: returns the number of calls of an interrupt's handler and the largest lateness of a call, in ticks. */
+uint32_t timer_interrupt_stats(uint8_t interrupt, timer_tick_t* late_max);
+
+#endif
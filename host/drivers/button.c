@@ -0,0 +1,102 @@
+/**
+    @file   button.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 button driver.
+*/
+
+#include <stdlib.h>
+#include "button.h"
+
+#define BUTTON_SEED_DEFAULT 1
+#define BUTTON_SEED_MIX 0x9e3779b9
+#define BUTTON_PRESS_CHANCE 320
+#define BUTTON_HOLD_MIN 20
+#define BUTTON_HOLD_MAX 100
+#define BUTTON_BOUNCE_UPDATES 3
+
+static uint32_t random_state;
+static bool down[BUTTON_NUM];
+static bool previous[BUTTON_NUM];
+static uint16_t held_updates[BUTTON_NUM];
+static uint8_t bouncing[BUTTON_NUM];
+
+
+/** Steps the xorshift sequence used to fake presses. */
+static uint32_t button_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
+
+
+/** Seeds the fake input sequence and releases the button. */
+void button_init(void)
+{
+    const char* seed = getenv("TETRIS_HOST_SEED");
+    uint8_t i;
+
+    random_state = (seed ? (uint32_t) strtoul(seed, NULL, 0) : BUTTON_SEED_DEFAULT) ^ BUTTON_SEED_MIX;
+
+    for (i = 0; i < BUTTON_NUM; i++) {
+        down[i] = false;
+        previous[i] = false;
+        held_updates[i] = 0;
+        bouncing[i] = 0;
+    }
+}
+
+
+/** Polls the fake button, which holds a press for a random number of updates and bounces as it closes and opens. */
+void button_update(void)
+{
+    uint32_t roll;
+    uint8_t i;
+
+    for (i = 0; i < BUTTON_NUM; i++) {
+        roll = button_random();
+        previous[i] = down[i];
+        down[i] = false;
+
+        if (held_updates[i]) {
+            held_updates[i]--;
+            down[i] = true;
+            if (held_updates[i] == 0) {
+                bouncing[i] = BUTTON_BOUNCE_UPDATES;
+            }
+        } else if (roll % BUTTON_PRESS_CHANCE == 0) {
+            held_updates[i] = BUTTON_HOLD_MIN + (roll >> 16) % BUTTON_HOLD_MAX;
+            down[i] = true;
+            bouncing[i] = BUTTON_BOUNCE_UPDATES;
+        }
+
+        if (bouncing[i]) {
+            bouncing[i]--;
+            down[i] = (roll >> 8) & 1;
+        }
+    }
+}
+
+
+/** Returns true if the button was pushed since the last update. */
+bool button_push_event_p(uint8_t button)
+{
+    return down[button] && !previous[button];
+}
+
+
+/** Returns true if the button was released since the last update. */
+bool button_release_event_p(uint8_t button)
+{
+    return !down[button] && previous[button];
+}
+
+
+/** Returns true if the button is held down. */
+bool button_down_p(uint8_t button)
+{
+    return down[button];
+}
@@ -0,0 +1,34 @@
+/**
+    @file   button.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 button driver.
+
+    Like the navswitch stand-in, the button is pressed by a pseudo random
+    sequence seeded from the TETRIS_HOST_SEED environment variable.
+*/
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include "system.h"
+
+#define BUTTON1 0
+#define BUTTON_NUM 1
+
+/** Seeds the fake input sequence and releases the button. */
+void button_init(void);
+
+/** Polls the fake button, which holds a press for a random number of updates and bounces as it closes and opens. */
+void button_update(void);
+
+/** Returns true if the button was pushed since the last update. */
+bool button_push_event_p(uint8_t button);
+
+/** Returns true if the button was released since the last update. */
+bool button_release_event_p(uint8_t button);
+
+/** Returns true if the button is held down. */
+bool button_down_p(uint8_t button);
+
+#endif
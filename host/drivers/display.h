@@ -0,0 +1,14 @@
+/**
+    @file   display.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 display dimensions.
+*/
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#define DISPLAY_WIDTH 5
+#define DISPLAY_HEIGHT 7
+
+#endif
@@ -0,0 +1,34 @@
+/**
+    @file   led.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 LED driver.
+*/
+
+#include "led.h"
+
+static bool leds[LED_NUM];
+
+
+/** Turns all LEDs off. */
+void led_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LED_NUM; i++)
+        leds[i] = false;
+}
+
+
+/** Turns an LED on or off. */
+void led_set(uint8_t led, bool state)
+{
+    leds[led] = state;
+}
+
+
+/** Returns whether an LED is on. */
+bool led_get(uint8_t led)
+{
+    return leds[led];
+}
@@ -0,0 +1,25 @@
+/**
+    @file   led.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 LED driver.
+*/
+
+#ifndef LED_H
+#define LED_H
+
+#include "system.h"
+
+#define LED1 0
+#define LED_NUM 1
+
+/** Turns all LEDs off. */
+void led_init(void);
+
+/** Turns an LED on or off. */
+void led_set(uint8_t led, bool state);
+
+/** Returns whether an LED is on. */
+bool led_get(uint8_t led);
+
+#endif
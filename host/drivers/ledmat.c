@@ -0,0 +1,109 @@
+/**
+    @file   ledmat.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 LED matrix driver.
+*/
+
+#include "ledmat.h"
+
+static uint8_t columns[DISPLAY_WIDTH];
+static uint32_t refreshes;
+
+/** The column being shown, since when, and when each column was last shown, if it has been. */
+static uint8_t shown_column;
+static timer_tick_t shown_since;
+static timer_tick_t shown_times[DISPLAY_WIDTH];
+static bool shown_before[DISPLAY_WIDTH];
+
+static timer_tick_t lit_times[DISPLAY_WIDTH][DISPLAY_HEIGHT];
+static timer_tick_t first_time;
+static timer_tick_t interval_max;
+
+
+/** Turns all the LEDs off and clears the framebuffer and the duty cycles. */
+void ledmat_init(void)
+{
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < DISPLAY_WIDTH; i++) {
+        columns[i] = 0;
+        shown_before[i] = false;
+        for (j = 0; j < DISPLAY_HEIGHT; j++)
+            lit_times[i][j] = 0;
+    }
+
+    refreshes = 0;
+    interval_max = 0;
+}
+
+
+/**
+    Shows a column, bit y of pattern lighting row y, in place of the one shown before. The time since
+    the last column was shown is added to each cell it lit.
+*/
+void ledmat_display_column(uint8_t pattern, uint8_t col)
+{
+    timer_tick_t now = timer_get();
+    uint8_t j;
+
+    if (refreshes == 0) {
+        first_time = now;
+    } else {
+        for (j = 0; j < DISPLAY_HEIGHT; j++) {
+            if (columns[shown_column] & BIT(j)) {
+                lit_times[shown_column][j] += now - shown_since;
+            }
+        }
+    }
+
+    // a column shown again straight after itself, for another bit plane, is the same showing
+    if (col != shown_column || refreshes == 0) {
+        if (shown_before[col] && now - shown_times[col] > interval_max) {
+            interval_max = now - shown_times[col];
+        }
+        shown_times[col] = now;
+        shown_before[col] = true;
+    }
+
+    columns[col] = pattern;
+    shown_column = col;
+    shown_since = now;
+    refreshes++;
+}
+
+
+/** Returns the pattern a column was last shown with. */
+uint8_t ledmat_column_get(uint8_t col)
+{
+    return columns[col];
+}
+
+
+/** Returns the number of columns shown so far. */
+uint32_t ledmat_refreshes(void)
+{
+    return refreshes;
+}
+
+
+/** Returns the time a cell was lit for, up to when the last column was shown, in timer ticks. */
+timer_tick_t ledmat_lit_time(uint8_t col, uint8_t row)
+{
+    return lit_times[col][row];
+}
+
+
+/** Returns the time from when the first column was shown to when the last was, in timer ticks. */
+timer_tick_t ledmat_time(void)
+{
+    return shown_since - first_time;
+}
+
+
+/** Returns the longest time between two showings of the same column, in timer ticks. */
+timer_tick_t ledmat_interval_max(void)
+{
+    return interval_max;
+}
@@ -0,0 +1,45 @@
+/**
+    @file   ledmat.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 LED matrix driver.
+
+    The column patterns are kept in a framebuffer the shape of the display, one bitmask per
+    column with bit y for row y, and the refreshes are counted, so the drawing can be checked
+    and timed without the board.
+
+    Each cell's duty cycle is recorded on the virtual clock (timer.h): how long it was lit, out of
+    the time since the first column was shown, which is what its brightness would be on the board.
+    The longest time between two showings of the same column is kept too, as a lit pixel flickers
+    when it is not shown again within about a fiftieth of a second.
+*/
+
+#ifndef LEDMAT_H
+#define LEDMAT_H
+
+#include "system.h"
+#include "display.h"
+#include "timer.h"
+
+/** Turns all the LEDs off and clears the framebuffer and the duty cycles. */
+void ledmat_init(void);
+
+/** Shows a column, bit y of pattern lighting row y, in place of the one shown before. */
+void ledmat_display_column(uint8_t pattern, uint8_t col);
+
+/** Returns the pattern a column was last shown with. */
+uint8_t ledmat_column_get(uint8_t col);
+
+/** Returns the number of columns shown so far. */
+uint32_t ledmat_refreshes(void);
+
+/** Returns the time a cell was lit for, up to when the last column was shown, in timer ticks. */
+timer_tick_t ledmat_lit_time(uint8_t col, uint8_t row);
+
+/** Returns the time from when the first column was shown to when the last was, in timer ticks. */
+timer_tick_t ledmat_time(void);
+
+/** Returns the longest time between two showings of the same column, in timer ticks. */
+timer_tick_t ledmat_interval_max(void);
+
+#endif
@@ -0,0 +1,107 @@
+/**
+    @file   navswitch.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 navswitch driver.
+*/
+
+#include <stdlib.h>
+#include "navswitch.h"
+
+#define NAVSWITCH_SEED_DEFAULT 1
+#define NAVSWITCH_PRESS_CHANCE 80
+#define NAVSWITCH_HOLD_MAX 400
+#define NAVSWITCH_BOUNCE_UPDATES 3
+
+static uint32_t random_state;
+static bool down[NAVSWITCH_NUM];
+static bool previous[NAVSWITCH_NUM];
+static uint8_t held;
+static uint16_t held_updates;
+static uint8_t bouncing;
+
+
+/** Steps the xorshift sequence used to fake presses. */
+static uint32_t navswitch_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
+
+
+/** Seeds the fake input sequence and releases all directions. */
+void navswitch_init(void)
+{
+    const char* seed = getenv("TETRIS_HOST_SEED");
+    uint8_t i;
+
+    random_state = seed ? (uint32_t) strtoul(seed, NULL, 0) : NAVSWITCH_SEED_DEFAULT;
+    if (random_state == 0) {
+        random_state = NAVSWITCH_SEED_DEFAULT;
+    }
+
+    for (i = 0; i < NAVSWITCH_NUM; i++) {
+        down[i] = false;
+        previous[i] = false;
+    }
+    held_updates = 0;
+    bouncing = 0;
+}
+
+
+/**
+    Polls the fake switch, which holds a pressed direction for a random number of updates, or may
+    press a new one. The held direction bounces for a few updates as it closes and opens.
+*/
+void navswitch_update(void)
+{
+    uint32_t roll = navswitch_random();
+    uint8_t i;
+
+    for (i = 0; i < NAVSWITCH_NUM; i++) {
+        previous[i] = down[i];
+        down[i] = false;
+    }
+
+    if (held_updates) {
+        held_updates--;
+        down[held] = true;
+        if (held_updates == 0) {
+            bouncing = NAVSWITCH_BOUNCE_UPDATES;
+        }
+    } else if (roll % NAVSWITCH_PRESS_CHANCE == 0) {
+        held = (roll >> 8) % NAVSWITCH_NUM;
+        held_updates = (roll >> 16) % NAVSWITCH_HOLD_MAX;
+        down[held] = true;
+        bouncing = NAVSWITCH_BOUNCE_UPDATES;
+    }
+
+    if (bouncing) {
+        bouncing--;
+        down[held] = (roll >> 24) & 1;
+    }
+}
+
+
+/** Returns true if the direction was pushed since the last update. */
+bool navswitch_push_event_p(uint8_t navswitch)
+{
+    return down[navswitch] && !previous[navswitch];
+}
+
+
+/** Returns true if the direction was released since the last update. */
+bool navswitch_release_event_p(uint8_t navswitch)
+{
+    return !down[navswitch] && previous[navswitch];
+}
+
+
+/** Returns true if the direction is held down. */
+bool navswitch_down_p(uint8_t navswitch)
+{
+    return down[navswitch];
+}
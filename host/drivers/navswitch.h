@@ -0,0 +1,46 @@
+/**
+    @file   navswitch.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 navswitch driver.
+
+    There is no switch on the host, so each update may press one direction
+    picked by a pseudo random sequence, and hold it for up to 400 updates. Like a real switch, it
+    bounces for a few updates as it closes and opens. The sequence is seeded from the
+    TETRIS_HOST_SEED environment variable so a run can be repeated.
+*/
+
+#ifndef NAVSWITCH_H
+#define NAVSWITCH_H
+
+#include "system.h"
+
+enum {
+    NAVSWITCH_NORTH,
+    NAVSWITCH_EAST,
+    NAVSWITCH_SOUTH,
+    NAVSWITCH_WEST,
+    NAVSWITCH_PUSH
+};
+
+#define NAVSWITCH_NUM 5
+
+/** Seeds the fake input sequence and releases all directions. */
+void navswitch_init(void);
+
+/**
+    Polls the fake switch, which holds a pressed direction for a random number of updates, or may
+    press a new one. The held direction bounces for a few updates as it closes and opens.
+*/
+void navswitch_update(void);
+
+/** Returns true if the direction was pushed since the last update. */
+bool navswitch_push_event_p(uint8_t navswitch);
+
+/** Returns true if the direction was released since the last update. */
+bool navswitch_release_event_p(uint8_t navswitch);
+
+/** Returns true if the direction is held down. */
+bool navswitch_down_p(uint8_t navswitch);
+
+#endif
@@ -0,0 +1,85 @@
+/**
+    @file   mmelody.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 mini melody player.
+*/
+
+#include "mmelody.h"
+
+#define MMELODY_OCTAVE_DEFAULT 4
+#define MMELODY_SPEED_DEFAULT 200
+#define MMELODY_NOTES_PER_OCTAVE 12
+#define MMELODY_VELOCITY 100
+
+/** Semitone offsets of the note letters A to G from C. */
+static const uint8_t note_offsets[] = { 9, 11, 0, 2, 4, 5, 7 };
+
+
+/** Sets up a silent melody player polled at poll_rate. */
+mmelody_t mmelody_init(mmelody_obj_t* dev, uint16_t poll_rate, mmelody_callback_t play_callback, void* play_callback_data)
+{
+    dev->tune = "";
+    dev->current = dev->tune;
+    dev->play_callback = play_callback;
+    dev->play_callback_data = play_callback_data;
+    dev->poll_rate = poll_rate;
+    dev->ticks = 0;
+    dev->octave = MMELODY_OCTAVE_DEFAULT;
+    mmelody_speed_set(dev, MMELODY_SPEED_DEFAULT);
+
+    return dev;
+}
+
+
+/** Starts playing a tune from the beginning. */
+void mmelody_play(mmelody_t melody, const char* str)
+{
+    melody->tune = str;
+    melody->current = str;
+    melody->ticks = 0;
+    melody->octave = MMELODY_OCTAVE_DEFAULT;
+    melody->play_callback(melody->play_callback_data, 0, 0);
+}
+
+
+/** Sets the tempo in beats per minute. */
+void mmelody_speed_set(mmelody_t melody, uint16_t speed)
+{
+    melody->ticks_per_beat = (uint32_t) melody->poll_rate * 60 / speed;
+}
+
+
+/** Advances the tune by one poll, playing the next note when a beat has passed. */
+void mmelody_update(mmelody_t melody)
+{
+    char c;
+    uint8_t note;
+
+    if (melody->ticks) {
+        melody->ticks--;
+        return;
+    }
+
+    c = *melody->current;
+    if (c == '\0') {
+        melody->play_callback(melody->play_callback_data, 0, 0);
+        return;
+    }
+
+    melody->current++;
+    melody->ticks = melody->ticks_per_beat;
+
+    if (c >= '0' && c <= '9') {
+        melody->octave = c - '0';
+    } else if (c >= 'A' && c <= 'G') {
+        note = (melody->octave + 1) * MMELODY_NOTES_PER_OCTAVE + note_offsets[c - 'A'];
+        if (*melody->current == '#') {
+            note++;
+            melody->current++;
+        }
+        melody->play_callback(melody->play_callback_data, note, MMELODY_VELOCITY);
+    } else {
+        melody->play_callback(melody->play_callback_data, 0, 0);
+    }
+}
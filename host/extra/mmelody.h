@@ -0,0 +1,44 @@
+/**
+    @file   mmelody.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 mini melody player.
+
+    Only note letters, sharps and octave digits are understood; every other
+    character of a tune is a rest of one beat. That is enough to drive the
+    tweeter at a realistic rate.
+*/
+
+#ifndef MMELODY_H
+#define MMELODY_H
+
+#include "system.h"
+
+typedef void (*mmelody_callback_t)(void* data, uint8_t note, uint8_t velocity);
+
+typedef struct {
+    const char* tune;
+    const char* current;
+    mmelody_callback_t play_callback;
+    void* play_callback_data;
+    uint16_t poll_rate;
+    uint16_t ticks_per_beat;
+    uint16_t ticks;
+    uint8_t octave;
+} mmelody_obj_t;
+
+typedef mmelody_obj_t* mmelody_t;
+
+/** Sets up a silent melody player polled at poll_rate. */
+mmelody_t mmelody_init(mmelody_obj_t* dev, uint16_t poll_rate, mmelody_callback_t play_callback, void* play_callback_data);
+
+/** Starts playing a tune from the beginning. */
+void mmelody_play(mmelody_t melody, const char* str);
+
+/** Sets the tempo in beats per minute. */
+void mmelody_speed_set(mmelody_t melody, uint16_t speed);
+
+/** Advances the tune by one poll, playing the next note when a beat has passed. */
+void mmelody_update(mmelody_t melody);
+
+#endif
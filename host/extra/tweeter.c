@@ -0,0 +1,54 @@
+/**
+    @file   tweeter.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 tweeter, a square wave note generator.
+*/
+
+#include "tweeter.h"
+
+
+/** Sets up a silent tweeter polled at poll_rate. */
+tweeter_t tweeter_init(tweeter_obj_t* dev, uint16_t poll_rate, tweeter_scale_t* scale_table)
+{
+    dev->poll_rate = poll_rate;
+    dev->scale_table = scale_table;
+    dev->half_period = 0;
+    dev->count = 0;
+    dev->state = false;
+
+    return dev;
+}
+
+
+/** Starts playing a note, a zero velocity or a note below octave 0 stops the tweeter. */
+void tweeter_note_play(tweeter_t tweeter, tweeter_note_t note, uint8_t velocity)
+{
+    if (note < TWEETER_NOTES || velocity == 0) {
+        tweeter->half_period = 0;
+        return;
+    }
+
+    tweeter->half_period = tweeter->scale_table[note % TWEETER_NOTES] >> (note / TWEETER_NOTES - 1);
+    if (tweeter->half_period == 0) {
+        tweeter->half_period = 1;
+    }
+    tweeter->count = 0;
+}
+
+
+/** Advances the square wave by one poll and returns the output level. */
+bool tweeter_update(tweeter_t tweeter)
+{
+    if (tweeter->half_period == 0) {
+        tweeter->state = false;
+        return false;
+    }
+
+    if (++tweeter->count >= tweeter->half_period) {
+        tweeter->count = 0;
+        tweeter->state = !tweeter->state;
+    }
+
+    return tweeter->state;
+}
@@ -0,0 +1,48 @@
+/**
+    @file   tweeter.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 tweeter, a square wave note generator.
+*/
+
+#ifndef TWEETER_H
+#define TWEETER_H
+
+#include "system.h"
+
+/** The number of polls per half period for each note of the lowest octave. */
+typedef uint16_t tweeter_scale_t;
+
+typedef uint8_t tweeter_note_t;
+
+#define TWEETER_NOTES 12
+
+/** Half periods of octave 0 (C0 to B0, MIDI notes 12 to 23), in polls of the tweeter at RATE. */
+#define TWEETER_SCALE_TABLE(RATE) {                         \
+    (RATE) * 100 / 3270 / 2, (RATE) * 100 / 3465 / 2,       \
+    (RATE) * 100 / 3671 / 2, (RATE) * 100 / 3889 / 2,       \
+    (RATE) * 100 / 4120 / 2, (RATE) * 100 / 4365 / 2,       \
+    (RATE) * 100 / 4625 / 2, (RATE) * 100 / 4900 / 2,       \
+    (RATE) * 100 / 5191 / 2, (RATE) * 100 / 5500 / 2,       \
+    (RATE) * 100 / 5827 / 2, (RATE) * 100 / 6174 / 2 }
+
+typedef struct {
+    uint16_t poll_rate;
+    tweeter_scale_t* scale_table;
+    uint16_t half_period;
+    uint16_t count;
+    bool state;
+} tweeter_obj_t;
+
+typedef tweeter_obj_t* tweeter_t;
+
+/** Sets up a silent tweeter polled at poll_rate. */
+tweeter_t tweeter_init(tweeter_obj_t* dev, uint16_t poll_rate, tweeter_scale_t* scale_table);
+
+/** Starts playing a note, a zero velocity or a note below octave 0 stops the tweeter. */
+void tweeter_note_play(tweeter_t tweeter, tweeter_note_t note, uint8_t velocity);
+
+/** Advances the square wave by one poll and returns the output level. */
+bool tweeter_update(tweeter_t tweeter);
+
+#endif
@@ -0,0 +1,23 @@
+/**
+    @file   font5x5_1.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 5x5 font, the host never draws glyphs.
+*/
+
+#ifndef FONT5X5_1_H
+#define FONT5X5_1_H
+
+#include "font.h"
+
+static font_t font5x5_1 = {
+    .flags = 0,
+    .width = 5,
+    .height = 5,
+    .offset = ' ',
+    .size = 0,
+    .bytes = 4,
+    .data = 0
+};
+
+#endif
@@ -0,0 +1,107 @@
+/**
+    @file   hal_host.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the hardware the game uses beyond the UCFK4 drivers.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hal.h"
+#include "timer.h"
+
+#define HAL_RUN_SECONDS_DEFAULT 60
+
+/** The stand-in timer's interrupts. */
+#define HAL_INTERRUPT_AUDIO 0
+#define HAL_INTERRUPT_INPUT 1
+
+
+/** Nothing to start on the host, the monotonic clock is always running. */
+void hal_cycles_init(void)
+{
+}
+
+
+/** Returns the monotonic clock in nanoseconds, which wraps around at 32 bits, so only differences of it are useful. */
+uint32_t hal_cycles(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t) now.tv_sec * HAL_CYCLE_RATE + now.tv_nsec;
+}
+
+
+/** Calls handler rate times a second on the virtual clock, from the stand-in timer's interrupt. */
+void hal_audio_start(uint16_t rate, hal_interrupt_t handler)
+{
+    timer_interrupt_set(HAL_INTERRUPT_AUDIO, TIMER_RATE / rate, handler);
+}
+
+
+/** Calls handler rate times a second on the virtual clock, from the stand-in timer's second interrupt. */
+void hal_input_start(uint16_t rate, hal_interrupt_t handler)
+{
+    timer_interrupt_set(HAL_INTERRUPT_INPUT, TIMER_RATE / rate, handler);
+}
+
+
+/** Returns the number of audio interrupts so far and their largest lateness on the virtual clock, in nanoseconds. */
+uint32_t hal_audio_stats(uint32_t* late_max)
+{
+    timer_tick_t late;
+    uint32_t calls = timer_interrupt_stats(HAL_INTERRUPT_AUDIO, &late);
+
+    *late_max = late * (HAL_CYCLE_RATE / TIMER_RATE);
+
+    return calls;
+}
+
+
+/** Nothing can cut in on the host, the stand-in interrupt is only called while the clock moves. */
+uint8_t hal_interrupts_disable(void)
+{
+    return 0;
+}
+
+
+/** Nothing to restore on the host. */
+void hal_interrupts_restore(__unused__ uint8_t state)
+{
+}
+
+
+/** Moves the virtual clock on to when, calling the interrupt handler on the way. */
+void hal_sleep_until(timer_tick_t when)
+{
+    timer_wait_until(when);
+}
+
+
+/** Runs a task, taking its scaled host time off the virtual clock when TETRIS_HOST_CPU_SCALE is set. */
+void hal_task_run(hal_task_t func, void* data)
+{
+    uint64_t start = timer_cpu_time();
+
+    func(data);
+    timer_charge(timer_cpu_time() - start);
+}
+
+
+/** Returns the virtual seconds to run for, from TETRIS_HOST_SECONDS. */
+uint16_t hal_run_seconds(void)
+{
+    const char* seconds = getenv("TETRIS_HOST_SECONDS");
+
+    return seconds ? (uint16_t) strtoul(seconds, NULL, 0) : HAL_RUN_SECONDS_DEFAULT;
+}
+
+
+/** Writes a line of text to standard error, which keeps it apart from the tools' own output. */
+void hal_console_write(const char* line)
+{
+    fputs(line, stderr);
+}
@@ -0,0 +1,23 @@
+/**
+    @file   font.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 font type.
+*/
+
+#ifndef FONT_H
+#define FONT_H
+
+#include "system.h"
+
+typedef struct {
+    uint8_t flags;
+    uint8_t width;
+    uint8_t height;
+    uint8_t offset;
+    uint8_t size;
+    uint8_t bytes;
+    const uint8_t* data;
+} font_t;
+
+#endif
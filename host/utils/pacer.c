@@ -0,0 +1,28 @@
+/**
+    @file   pacer.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 pacer, paced on the virtual timer.
+*/
+
+#include "pacer.h"
+#include "timer.h"
+
+static timer_tick_t pacer_period;
+static timer_tick_t pacer_next;
+
+
+/** Sets the rate the pacer waits for, in hertz. */
+void pacer_init(uint16_t pacer_rate)
+{
+    pacer_period = TIMER_RATE / pacer_rate;
+    pacer_next = timer_get() + pacer_period;
+}
+
+
+/** Moves the virtual timer forward to the next pacer period. */
+void pacer_wait(void)
+{
+    timer_wait_until(pacer_next);
+    pacer_next += pacer_period;
+}
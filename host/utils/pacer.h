@@ -0,0 +1,19 @@
+/**
+    @file   pacer.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 pacer, paced on the virtual timer.
+*/
+
+#ifndef PACER_H
+#define PACER_H
+
+#include "system.h"
+
+/** Sets the rate the pacer waits for, in hertz. */
+void pacer_init(uint16_t pacer_rate);
+
+/** Moves the virtual timer forward to the next pacer period. */
+void pacer_wait(void);
+
+#endif
@@ -0,0 +1,99 @@
+/**
+    @file   tinygl.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 tiny graphics library.
+*/
+
+#include "tinygl.h"
+#include "ledmat.h"
+
+static uint8_t columns[TINYGL_WIDTH];
+static const font_t* text_font;
+static const char* text;
+static uint16_t rate;
+static uint32_t updates;
+static uint8_t update_column;
+
+
+/** Clears the display and remembers the update rate. */
+void tinygl_init(const uint16_t update_rate)
+{
+    rate = update_rate;
+    updates = 0;
+    tinygl_clear();
+}
+
+
+/** Sets the font used for text. */
+void tinygl_font_set(const font_t* font)
+{
+    text_font = font;
+}
+
+
+/** Sets the text speed in characters per ten seconds. */
+void tinygl_text_speed_set(__unused__ uint8_t speed)
+{
+}
+
+
+/** Sets how text is shown. */
+void tinygl_text_mode_set(__unused__ tinygl_text_mode_t mode)
+{
+}
+
+
+/** Remembers the text to show. */
+void tinygl_text(const char* string)
+{
+    text = string;
+}
+
+
+/** Sets a pixel on the display. */
+void tinygl_draw_point(tinygl_point_t point, tinygl_pixel_value_t pixel_value)
+{
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT)
+        return;
+
+    if (pixel_value) {
+        columns[point.x] |= BIT(point.y);
+    } else {
+        columns[point.x] &= ~BIT(point.y);
+    }
+}
+
+
+/** Returns the value of a pixel on the display. */
+tinygl_pixel_value_t tinygl_pixel_get(tinygl_point_t point)
+{
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT)
+        return 0;
+
+    return (columns[point.x] >> point.y) & 1;
+}
+
+
+/** Counts a refresh of the display, and shows the next column of the points on the LED matrix as the display driver does. */
+void tinygl_update(void)
+{
+    updates++;
+
+    ledmat_display_column(columns[update_column], update_column);
+    if (++update_column >= TINYGL_WIDTH) {
+        update_column = 0;
+    }
+}
+
+
+/** Clears the display and any text. */
+void tinygl_clear(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < TINYGL_WIDTH; i++)
+        columns[i] = 0;
+
+    text = 0;
+}
@@ -0,0 +1,63 @@
+/**
+    @file   tinygl.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 tiny graphics library.
+
+    Points are kept in a column bitmap the same shape as the display driver
+    uses, shown a column per update on the LED matrix stand-in, and text is
+    remembered but never scrolled.
+*/
+
+#ifndef TINYGL_H
+#define TINYGL_H
+
+#include "system.h"
+#include "display.h"
+#include "font.h"
+
+#define TINYGL_WIDTH DISPLAY_WIDTH
+#define TINYGL_HEIGHT DISPLAY_HEIGHT
+
+typedef int8_t tinygl_coord_t;
+
+typedef struct {
+    tinygl_coord_t x;
+    tinygl_coord_t y;
+} tinygl_point_t;
+
+typedef uint8_t tinygl_pixel_value_t;
+
+typedef enum {
+    TINYGL_TEXT_MODE_STEP,
+    TINYGL_TEXT_MODE_SCROLL
+} tinygl_text_mode_t;
+
+/** Clears the display and remembers the update rate. */
+void tinygl_init(const uint16_t update_rate);
+
+/** Sets the font used for text. */
+void tinygl_font_set(const font_t* font);
+
+/** Sets the text speed in characters per ten seconds. */
+void tinygl_text_speed_set(uint8_t speed);
+
+/** Sets how text is shown. */
+void tinygl_text_mode_set(tinygl_text_mode_t mode);
+
+/** Remembers the text to show. */
+void tinygl_text(const char* string);
+
+/** Sets a pixel on the display. */
+void tinygl_draw_point(tinygl_point_t point, tinygl_pixel_value_t pixel_value);
+
+/** Returns the value of a pixel on the display. */
+tinygl_pixel_value_t tinygl_pixel_get(tinygl_point_t point);
+
+/** Counts a refresh of the display, and shows the next column of the points on the LED matrix as the display driver does. */
+void tinygl_update(void);
+
+/** Clears the display and any text. */
+void tinygl_clear(void);
+
+#endif
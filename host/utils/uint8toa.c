@@ -0,0 +1,30 @@
+/**
+    @file   uint8toa.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 unsigned byte to string conversion.
+*/
+
+#include "uint8toa.h"
+
+
+/** Writes num as decimal into str, optionally padded to three digits, and returns str. */
+char* uint8toa(uint8_t num, char* str, bool leading_zeros)
+{
+    char* s = str;
+    uint8_t divisor;
+    uint8_t digit;
+
+    for (divisor = 100; divisor > 1; divisor /= 10) {
+        digit = num / divisor;
+        num %= divisor;
+        if (digit || leading_zeros || s != str) {
+            *s++ = '0' + digit;
+        }
+    }
+
+    *s++ = '0' + num;
+    *s = '\0';
+
+    return str;
+}
@@ -0,0 +1,16 @@
+/**
+    @file   uint8toa.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Host stand-in for the UCFK4 unsigned byte to string conversion.
+*/
+
+#ifndef UINT8TOA_H
+#define UINT8TOA_H
+
+#include "system.h"
+
+/** Writes num as decimal into str, optionally padded to three digits, and returns str. */
+char* uint8toa(uint8_t num, char* str, bool leading_zeros);
+
+#endif
@@ -0,0 +1,206 @@
+/**
+    @file   input.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Queues the pushes of the navswitch and button as timestamped game inputs.
+*/
+
+#include "button.h"
+#include "hal.h"
+#include "input.h"
+#include "navswitch.h"
+
+#if INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)
+#error "The input queue indexes wrap around, so its size must be a power of two"
+#endif
+
+/** Keeps the compiler from moving memory accesses across it, so an event is written before it is published. */
+#define INPUT_BARRIER() __asm__ volatile("" : : : "memory")
+
+/** The navswitch directions and the game inputs they stand for. */
+static const game_input_t navswitch_inputs[NAVSWITCH_NUM] = {
+    [NAVSWITCH_NORTH] = GAME_INPUT_HARD_DROP,
+    [NAVSWITCH_EAST] = GAME_INPUT_RIGHT,
+    [NAVSWITCH_SOUTH] = GAME_INPUT_DOWN,
+    [NAVSWITCH_WEST] = GAME_INPUT_LEFT,
+    [NAVSWITCH_PUSH] = GAME_INPUT_ROTATE_CLOCKWISE
+};
+
+/** The debounced state of a switch, and how many samples in a row have read it the other way, since the tick of the first. */
+typedef struct {
+    bool down;
+    uint8_t count;
+    timer_tick_t since;
+} input_switch_t;
+
+/** The navswitch directions, then the button. */
+static input_switch_t switches[NAVSWITCH_NUM + 1];
+
+static input_event_t queue[INPUT_QUEUE_SIZE];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_tail;
+
+static input_stats_t stats;
+static timer_tick_t applied_time;
+static bool applied;
+
+
+/** Puts a push or release on the queue, unless it is full. Only the sampling interrupt calls this. */
+static void input_push(game_input_t input, bool released, timer_tick_t time)
+{
+    uint8_t head = queue_head;
+
+    if ((uint8_t) (head - queue_tail) == INPUT_QUEUE_SIZE) {
+        stats.dropped++;
+        return;
+    }
+
+    queue[head % INPUT_QUEUE_SIZE].time = time;
+    queue[head % INPUT_QUEUE_SIZE].input = input;
+    queue[head % INPUT_QUEUE_SIZE].released = released;
+    INPUT_BARRIER();
+    queue_head = head + 1;
+    stats.events++;
+}
+
+
+/**
+    Takes a sample of a switch, returns true once it has read the other way for INPUT_DEBOUNCE_SAMPLES
+    samples in a row, which changes its state. A bounce shorter than that is ignored.
+*/
+static bool input_debounce(input_switch_t* input_switch, bool down, timer_tick_t now)
+{
+    if (down == input_switch->down) {
+        input_switch->count = 0;
+        return false;
+    }
+
+    if (input_switch->count++ == 0) {
+        input_switch->since = now;
+    }
+
+    if (input_switch->count < INPUT_DEBOUNCE_SAMPLES) {
+        return false;
+    }
+
+    input_switch->down = down;
+    input_switch->count = 0;
+
+    return true;
+}
+
+
+/** Called by the sampling interrupt to queue the debounced pushes, and the releases of the repeating buttons. */
+static void input_sample(void)
+{
+    timer_tick_t now = timer_get();
+    input_switch_t* input_switch;
+    uint8_t i;
+
+    navswitch_update();
+    button_update();
+
+    for (i = 0; i < NAVSWITCH_NUM; i++) {
+        input_switch = &switches[i];
+        if (!input_debounce(input_switch, navswitch_down_p(i), now)) {
+            continue;
+        }
+        if (input_switch->down) {
+            input_push(navswitch_inputs[i], false, input_switch->since);
+        } else if (navswitch_inputs[i] & GAME_INPUT_REPEATING) {
+            input_push(navswitch_inputs[i], true, input_switch->since);
+        }
+    }
+
+    input_switch = &switches[NAVSWITCH_NUM];
+    if (input_debounce(input_switch, button_down_p(BUTTON1), now) && input_switch->down) {
+        input_push(GAME_INPUT_ROTATE_COUNTERCLOCKWISE, false, input_switch->since);
+    }
+}
+
+
+/** Initializes the navswitch and button, empties the queue and starts sampling. */
+void input_init(void)
+{
+    uint8_t i;
+
+    button_init();
+    navswitch_init();
+
+    for (i = 0; i <= NAVSWITCH_NUM; i++) {
+        switches[i].down = false;
+        switches[i].count = 0;
+    }
+
+    queue_head = 0;
+    queue_tail = 0;
+    applied = false;
+
+    hal_input_start(INPUT_SAMPLE_RATE, input_sample);
+}
+
+
+/** Copies the oldest queued push or release to event and returns true, or returns false if there is none. */
+bool input_peek(input_event_t* event)
+{
+    uint8_t tail = queue_tail;
+
+    if (tail == queue_head) {
+        return false;
+    }
+
+    INPUT_BARRIER();
+    *event = queue[tail % INPUT_QUEUE_SIZE];
+
+    return true;
+}
+
+
+/** Takes the oldest queued push or release off the queue. */
+void input_pop(void)
+{
+    INPUT_BARRIER();
+    queue_tail++;
+}
+
+
+/** Notes that a push seen at time was applied by a game step, so the next frame drawn shows it. */
+void input_applied(timer_tick_t time)
+{
+    if (!applied) {
+        applied_time = time;
+        applied = true;
+    }
+}
+
+
+/** Notes that a frame was drawn, which shows the oldest push applied since the last frame. */
+void input_shown(void)
+{
+    timer_tick_t latency;
+
+    if (!applied) {
+        return;
+    }
+
+    latency = timer_get() - applied_time;
+    stats.shown++;
+    stats.latency_total += latency;
+    if (latency > stats.latency_max) {
+        stats.latency_max = latency;
+    }
+    applied = false;
+}
+
+
+/** Returns the input statistics, read with interrupts off as the sampling interrupt counts pushes. */
+input_stats_t input_stats(void)
+{
+    input_stats_t copy;
+    uint8_t state = hal_interrupts_disable();
+
+    copy = stats;
+    hal_interrupts_restore(state);
+
+    return copy;
+}
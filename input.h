@@ -0,0 +1,66 @@
+/**
+    @file   input.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Queues the pushes of the navswitch and button as timestamped game inputs.
+
+    A timer interrupt samples the navswitch and button INPUT_SAMPLE_RATE times a second and puts
+    each push into a ring buffer as the game input it stands for, with the timer tick it was seen
+    at. A switch bounces for a few milliseconds when it is pushed or released, so a change is only
+    taken once INPUT_DEBOUNCE_SAMPLES samples in a row have read it, and is timed from the first of
+    them. The releases of the buttons that repeat while held are queued too, so the game task knows
+    which are held. The interrupt is the only writer of the buffer and the game task the only reader, each
+    moving its own index, so neither has to turn interrupts off. Pushes that find the buffer full
+    are dropped and counted.
+
+    The latency from input to photon is the time from a push to the drawing of the first frame
+    after the game step that applied it. The LED matrix then shows the frame as its rows are next
+    lit.
+*/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "system.h"
+#include "game.h"
+#include "timer.h"
+
+#define INPUT_SAMPLE_RATE 1000
+#define INPUT_DEBOUNCE_SAMPLES 5
+#define INPUT_QUEUE_SIZE 16
+
+/** A push or release of the navswitch or button, as a single game input, and the timer tick it was seen at. */
+typedef struct {
+    timer_tick_t time;
+    game_input_t input;
+    bool released;
+} input_event_t;
+
+/** The counts of pushes and releases queued and dropped, and of inputs shown with the total and largest latency, in timer ticks. */
+typedef struct {
+    uint32_t events;
+    uint32_t dropped;
+    uint32_t shown;
+    uint32_t latency_total;
+    timer_tick_t latency_max;
+} input_stats_t;
+
+/** Initializes the navswitch and button, empties the queue and starts sampling. */
+void input_init(void);
+
+/** Copies the oldest queued push or release to event and returns true, or returns false if there is none. */
+bool input_peek(input_event_t* event);
+
+/** Takes the oldest queued push or release off the queue. */
+void input_pop(void);
+
+/** Notes that a push seen at time was applied by a game step, so the next frame drawn shows it. */
+void input_applied(timer_tick_t time);
+
+/** Notes that a frame was drawn, which shows the oldest push applied since the last frame. */
+void input_shown(void);
+
+/** Returns the input statistics. */
+input_stats_t input_stats(void);
+
+#endif
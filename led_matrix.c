@@ -2,13 +2,14 @@
     @file   led_matrix.c
     @author Vince Alain W. Verwilligen (vav18), Sam Clark (scl113)
     @date   21 October 2021
-    @brief  Controls the display of the led matrix using tinygl.
+    @brief  Controls the display of the led matrix, using tinygl for text.
 */
 
 #include <string.h>
 #include "system.h"
 #include "../fonts/font5x5_1.h"
 #include "tinygl.h"
+#include "ledmat.h"
 #include "led_matrix.h"
 #include "uint8toa.h"
 
@@ -16,6 +17,28 @@
 #define GAME_START_MESSAGE "Push button to start :)\0"
 #define GAME_OVER_MESSAGE "Game Over - Lines:"
 
+/** The frame last drawn, so only the pixels that differ from it are drawn again. */
+static led_matrix_frame_t shown;
+
+/** The game's own framebuffer, for each bit plane one bitmask per column with bit y for row y, as the LED matrix driver takes them. */
+static uint8_t columns[LED_MATRIX_PLANES][TINYGL_WIDTH];
+
+/** Whether the game's framebuffer is shown rather than tinygl's text, and the column and plane it shows next. */
+static bool drawing;
+static uint8_t update_column;
+static uint8_t update_plane;
+
+
+/** Goes back to showing tinygl's text, clearing the game's framebuffer and the rows last drawn. */
+static void led_matrix_stop_drawing(void)
+{
+    led_matrix_frame_clear(&shown);
+    memset(columns, 0, sizeof(columns));
+
+    drawing = false;
+    update_plane = 0;
+}
+
 
 /** Initializes tinygl to display text and draw pixels. */
 void led_matrix_init(uint16_t rate)
@@ -23,13 +46,43 @@ void led_matrix_init(uint16_t rate)
     tinygl_init(rate);
     tinygl_font_set(&font5x5_1);
     tinygl_text_speed_set(MESSAGE_RATE);
+    led_matrix_stop_drawing();
 }
 
 
-/** Checks for updates for the display task and lets tinygl know. */
-void led_matrix_update(void)
+/**
+    Shows the next column of the display, and returns the slots it is to be shown for, the time to
+    the next call in LED_MATRIX_SLOTS per column. While the game is drawing, each bit plane of the
+    column is copied straight from the game's framebuffer to the LED matrix driver in turn, otherwise
+    tinygl is updated to scroll its text, one column per call for all the slots.
+*/
+uint8_t led_matrix_update(void)
 {
-    tinygl_update();
+    uint8_t pattern;
+    uint8_t slots = 0;
+
+    if (!drawing) {
+        tinygl_update();
+        return LED_MATRIX_SLOTS;
+    }
+
+    pattern = columns[update_plane][update_column];
+    ledmat_display_column(pattern, update_column);
+
+    // the planes after this one with the same pattern need not be shown again, it is left on for their slots too
+    do {
+        slots += BIT(update_plane);
+        update_plane++;
+    } while (update_plane < LED_MATRIX_PLANES && columns[update_plane][update_column] == pattern);
+
+    if (update_plane >= LED_MATRIX_PLANES) {
+        update_plane = 0;
+        if (++update_column >= TINYGL_WIDTH) {
+            update_column = 0;
+        }
+    }
+
+    return slots;
 }
 
 
@@ -38,6 +91,7 @@ void led_matrix_display_start(void)
 {
     tinygl_text_mode_set(TINYGL_TEXT_MODE_SCROLL);
     tinygl_text(GAME_START_MESSAGE);
+    led_matrix_stop_drawing();
 }
 
 
@@ -54,28 +108,65 @@ void led_matrix_display_game_over_and_lines(char* message, uint8_t lines)
     tinygl_text_mode_set(TINYGL_TEXT_MODE_SCROLL);
     tinygl_clear ();
     tinygl_text(message);
+    led_matrix_stop_drawing();
+}
+
+
+/** Turns all the pixels of a frame off. */
+void led_matrix_frame_clear(led_matrix_frame_t* frame)
+{
+    memset(frame, 0, sizeof(*frame));
 }
 
 
-/** Lets tinygl draw all pixels used by tetrominos. */
-void led_matrix_draw(uint8_t* display)
+/** Lights the pixels of a frame set in rows, one bitmask per row, at least as bright as level. */
+void led_matrix_frame_add(led_matrix_frame_t* frame, const uint8_t* rows, uint8_t level)
 {
-    uint8_t index = 0;
+    uint8_t plane;
+    uint8_t j;
+
+    for (plane = 0; plane < LED_MATRIX_PLANES; plane++) {
+        if (level & BIT(plane)) {
+            for (j = 0; j < TINYGL_HEIGHT; j++)
+                frame->planes[plane][j] |= rows[j];
+        }
+    }
+}
+
+
+/**
+    Draws a frame into the game's framebuffer, and shows it from then on in place of tinygl. Only the
+    pixels that changed since the last draw are flipped, each row's changes found by XORing it with
+    the row last drawn, so an unchanged frame costs a compare per row and plane.
+*/
+void led_matrix_draw(led_matrix_frame_t* frame)
+{
+    uint8_t changed;
+    uint8_t plane;
     uint8_t i;
     uint8_t j;
 
-    for (j = 0; j < TINYGL_HEIGHT; j++) {
-        for (i = 0; i < TINYGL_WIDTH; i++) {
-            tinygl_point_t point = { i, j };
+    drawing = true;
 
-            tinygl_draw_point(point, display[index++]);
+    for (plane = 0; plane < LED_MATRIX_PLANES; plane++) {
+        for (j = 0; j < TINYGL_HEIGHT; j++) {
+            changed = frame->planes[plane][j] ^ shown.planes[plane][j];
+
+            for (i = 0; changed; i++, changed >>= 1) {
+                if (changed & 1) {
+                    columns[plane][i] ^= BIT(j);
+                }
+            }
         }
     }
+
+    shown = *frame;
 }
 
 
-/** Lets tinygl clear the display. */
+/** Lets tinygl clear the display, and goes back to showing it in place of the game's framebuffer. */
 void led_matrix_clear(void)
 {
     tinygl_clear();
+    led_matrix_stop_drawing();
 }
\ No newline at end of file
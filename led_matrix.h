@@ -2,17 +2,46 @@
     @file   led_matrix.h
     @author Vince Alain W. Verwilligen (vav18), Sam Clark (scl113)
     @date   21 October 2021
-    @brief  Controls the display of the led matrix using tinygl.
+    @brief  Controls the display of the led matrix, using tinygl for text.
+
+    During a game the pixels skip tinygl and the display driver: they are kept in the game's own
+    framebuffer of column bitmasks, and each update hands a column straight to the LED matrix driver.
+
+    Game pixels have LED_MATRIX_LEVEL_MAX + 1 brightness levels, shown by bit angle modulation: the
+    framebuffer holds a bit plane per bit of the level, and each column shows plane b for 2^b slots,
+    so a pixel is lit for level / LED_MATRIX_LEVEL_MAX of its column's time. A column whose planes are
+    the same is shown once for all its slots, so on and off pixels cost no more than they did.
 */
 
 #ifndef H_LED_MATRIX
 #define H_LED_MATRIX
 
+#include "system.h"
+#include "tinygl.h"
+
+/** The bit planes of the framebuffer, and the brightness levels they make. */
+#define LED_MATRIX_PLANES 2
+#define LED_MATRIX_LEVEL_MAX ((1 << LED_MATRIX_PLANES) - 1)
+#define LED_MATRIX_LEVEL_DIM 1
+
+/** The slots a column is shown for, one per brightness level above off. */
+#define LED_MATRIX_SLOTS LED_MATRIX_LEVEL_MAX
+
+/** A frame of the game, one row bitmask per row of the display for each bit plane. */
+typedef struct {
+    uint8_t planes[LED_MATRIX_PLANES][TINYGL_HEIGHT];
+} led_matrix_frame_t;
+
 /** Initializes tinygl to display text and draw pixels. */
 void led_matrix_init(uint16_t rate);
 
-/** Checks for updates for the display task and lets tinygl know. */
-void led_matrix_update(void);
+/**
+    Shows the next column of the display, and returns the slots it is to be shown for, the time to
+    the next call in LED_MATRIX_SLOTS per column. While the game is drawing, each bit plane of the
+    column is copied straight from the game's framebuffer to the LED matrix driver in turn, otherwise
+    tinygl is updated to scroll its text, one column per call for all the slots.
+*/
+uint8_t led_matrix_update(void);
 
 /** Let tinygl show the message before starting the game. */
 void led_matrix_display_start(void);
@@ -20,10 +49,20 @@ void led_matrix_display_start(void);
 /** Let tinygl show the game over message and the amount of lines scored. */
 void led_matrix_display_game_over_and_lines(char* message, uint8_t lines);
 
-/** Lets tinygl draw all pixels used by tetrominos. */
-void led_matrix_draw(uint8_t* display);
+/** Turns all the pixels of a frame off. */
+void led_matrix_frame_clear(led_matrix_frame_t* frame);
+
+/** Lights the pixels of a frame set in rows, one bitmask per row, at least as bright as level. */
+void led_matrix_frame_add(led_matrix_frame_t* frame, const uint8_t* rows, uint8_t level);
+
+/**
+    Draws a frame into the game's framebuffer, and shows it from then on in place of tinygl. Only the
+    pixels that changed since the last draw are flipped, each row's changes found by XORing it with
+    the row last drawn, so an unchanged frame costs a compare per row and plane.
+*/
+void led_matrix_draw(led_matrix_frame_t* frame);
 
-/** Lets tinygl clear the display. */
+/** Lets tinygl clear the display, and goes back to showing it in place of the game's framebuffer. */
 void led_matrix_clear(void);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,186 @@
+/**
+    @file   placement.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Finds every place the falling tetromino can come to rest, and the inputs that take it there.
+*/
+
+#include <string.h>
+#include "placement.h"
+
+#define PLACEMENT_ROOT 0xffff
+
+/** The moves searched, in the order the game applies its inputs. */
+static const game_input_t moves[] = {
+    GAME_INPUT_ROTATE_CLOCKWISE,
+    GAME_INPUT_DOWN,
+    GAME_INPUT_LEFT,
+    GAME_INPUT_RIGHT,
+    GAME_INPUT_ROTATE_COUNTERCLOCKWISE
+};
+
+
+/** Applies one move to a tetromino. */
+static void placement_move(tetromino_t* tetromino, game_input_t move)
+{
+    switch (move)
+    {
+        case GAME_INPUT_ROTATE_CLOCKWISE :
+            tetromino_rotate_clockwise(tetromino);
+            break;
+        case GAME_INPUT_DOWN :
+            tetromino_move_down(tetromino);
+            break;
+        case GAME_INPUT_LEFT :
+            tetromino_move_left(tetromino);
+            break;
+        case GAME_INPUT_RIGHT :
+            tetromino_move_right(tetromino);
+            break;
+        case GAME_INPUT_ROTATE_COUNTERCLOCKWISE :
+            tetromino_rotate_counterclockwise(tetromino);
+            break;
+    }
+}
+
+
+/** Sets a bit in a bitset, returns false if it was already set. */
+static bool placement_mark(uint8_t* bitset, uint16_t index)
+{
+    if (bitset[index / 8] & BIT(index % 8)) {
+        return false;
+    }
+
+    bitset[index / 8] |= BIT(index % 8);
+
+    return true;
+}
+
+
+/**
+    Works out for each rotation of the tetromino type the first rotation with the same shape.
+    Two rotations with the same shape in the same box cover the same pixels.
+*/
+static void placement_canonical_rotations(tetromino_shape_t* shapes, uint8_t* canonical)
+{
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < MAX_ROTATIONS; i++) {
+        for (j = 0; j <= i; j++) {
+            if (shapes[i].width == shapes[j].width && shapes[i].height == shapes[j].height
+                && memcmp(shapes[i].rows, shapes[j].rows, sizeof(shapes[i].rows)) == 0) {
+                canonical[i] = j;
+                break;
+            }
+        }
+    }
+}
+
+
+/** Adds a node to the search if its position has not been tried before and the tetromino fits there. */
+static void placement_visit(placement_list_t* list, tetrion_t* tetrion, tetromino_shape_t* shapes,
+    tetromino_t* tetromino, uint16_t parent, game_input_t input)
+{
+    placement_node_t* node;
+
+    if (tetromino->position.x < 0 || tetromino->position.x >= PLACEMENT_COLUMNS
+        || tetromino->position.y < 0 || tetromino->position.y >= PLACEMENT_ROWS) {
+        return;
+    }
+
+    if (!placement_mark(list->visited, (tetromino->rotation * PLACEMENT_ROWS + tetromino->position.y) * PLACEMENT_COLUMNS + tetromino->position.x)) {
+        return;
+    }
+
+    if (!tetrion_fits_shape(tetrion, &shapes[tetromino->rotation], tetromino->position)) {
+        return;
+    }
+
+    node = &list->nodes[list->node_count++];
+    node->tetromino = *tetromino;
+    node->parent = parent;
+    node->input = input;
+}
+
+
+/** Finds every placement the current tetromino of the tetrion can reach and returns how many there are. */
+uint16_t placement_generate(tetrion_t* tetrion, placement_list_t* list)
+{
+    tetromino_shape_t shapes[MAX_ROTATIONS];
+    uint8_t canonical[MAX_ROTATIONS];
+    tetromino_t tetromino = tetrion->current_tetromino;
+    uint16_t head;
+    uint16_t key;
+    uint8_t i;
+
+    list->node_count = 0;
+    list->count = 0;
+    memset(list->visited, 0, sizeof(list->visited));
+    memset(list->placed, 0, sizeof(list->placed));
+
+    for (i = 0; i < MAX_ROTATIONS; i++) {
+        tetromino.rotation = i;
+        tetromino_get_shape(&tetromino, &shapes[i]);
+    }
+    placement_canonical_rotations(shapes, canonical);
+
+    placement_visit(list, tetrion, shapes, &tetrion->current_tetromino, PLACEMENT_ROOT, GAME_INPUT_NONE);
+
+    for (head = 0; head < list->node_count; head++) {
+        tetromino = list->nodes[head].tetromino;
+        tetromino_move_down(&tetromino);
+
+        if (!tetrion_fits_shape(tetrion, &shapes[tetromino.rotation], tetromino.position)) {
+            // at rest, listed once for the pixels its box covers
+            tetromino = list->nodes[head].tetromino;
+            key = (canonical[tetromino.rotation] * TETRION_HEIGHT + tetromino.position.y + shapes[tetromino.rotation].top)
+                * TETRION_WIDTH + tetromino.position.x + shapes[tetromino.rotation].left;
+
+            if (placement_mark(list->placed, key)) {
+                list->placements[list->count++] = head;
+            }
+        }
+
+        for (i = 0; i < ARRAY_SIZE(moves); i++) {
+            tetromino = list->nodes[head].tetromino;
+            placement_move(&tetromino, moves[i]);
+            placement_visit(list, tetrion, shapes, &tetromino, head, moves[i]);
+        }
+    }
+
+    return list->count;
+}
+
+
+/** Returns the tetromino as it rests at a placement. */
+tetromino_t placement_get_tetromino(placement_list_t* list, uint16_t index)
+{
+    return list->nodes[list->placements[index]].tetromino;
+}
+
+
+/**
+    Writes the inputs that take the current tetromino to a placement into path, one input per step,
+    and returns how many there are. Returns 0 without writing if the path is longer than size.
+*/
+uint16_t placement_get_path(placement_list_t* list, uint16_t index, game_input_t* path, uint16_t size)
+{
+    uint16_t node = list->placements[index];
+    uint16_t length = 0;
+    uint16_t i;
+
+    for (i = node; list->nodes[i].parent != PLACEMENT_ROOT; i = list->nodes[i].parent) {
+        length++;
+    }
+
+    if (length > size) {
+        return 0;
+    }
+
+    for (i = length; list->nodes[node].parent != PLACEMENT_ROOT; node = list->nodes[node].parent) {
+        path[--i] = list->nodes[node].input;
+    }
+
+    return length;
+}
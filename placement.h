@@ -0,0 +1,57 @@
+/**
+    @file   placement.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Finds every place the falling tetromino can come to rest, and the inputs that take it there.
+
+    The search is a breadth first search over the tetromino's position and rotation, using the same
+    moves as the game (left, right, down and both rotations), so every path found is the shortest
+    sequence of inputs that reaches its placement. Placements that cover the same pixels are only
+    listed once, so the symmetric rotations of the o, i, s and z tetrominos are not repeated.
+*/
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include "game.h"
+
+/** Positions a fitting tetromino can have, its box stays on the tetrion and no pixel is more than 2 from its center. */
+#define PLACEMENT_COLUMNS (TETRION_WIDTH + 2)
+#define PLACEMENT_ROWS (TETRION_HEIGHT + 2)
+#define PLACEMENT_STATES (PLACEMENT_COLUMNS * PLACEMENT_ROWS * MAX_ROTATIONS)
+
+/** A step of the search, the tetromino reached and the input that reached it from its parent step. */
+typedef struct {
+    tetromino_t tetromino;
+    uint16_t parent;
+    game_input_t input;
+} placement_node_t;
+
+/**
+    The result of a search.
+     - The nodes are every position and rotation reached, in the order they were found.
+     - The placements are the nodes where the tetromino comes to rest, one per set of pixels covered.
+     - The visited and placed bitsets mark the positions already searched and the placements already listed.
+*/
+typedef struct {
+    placement_node_t nodes[PLACEMENT_STATES];
+    uint16_t node_count;
+    uint16_t placements[PLACEMENT_STATES];
+    uint16_t count;
+    uint8_t visited[(PLACEMENT_STATES + 7) / 8];
+    uint8_t placed[(TETRION_WIDTH * TETRION_HEIGHT * MAX_ROTATIONS + 7) / 8];
+} placement_list_t;
+
+/** Finds every placement the current tetromino of the tetrion can reach and returns how many there are. */
+uint16_t placement_generate(tetrion_t* tetrion, placement_list_t* list);
+
+/** Returns the tetromino as it rests at a placement. */
+tetromino_t placement_get_tetromino(placement_list_t* list, uint16_t index);
+
+/**
+    Writes the inputs that take the current tetromino to a placement into path, one input per step,
+    and returns how many there are. Returns 0 without writing if the path is longer than size.
+*/
+uint16_t placement_get_path(placement_list_t* list, uint16_t index, game_input_t* path, uint16_t size);
+
+#endif
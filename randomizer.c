@@ -0,0 +1,146 @@
+/**
+    @file   randomizer.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Chooses the type of each new tetromino from a seed, so the same seed always gives the same sequence.
+*/
+
+#include "randomizer.h"
+#include "tetromino.h"
+
+#if RANDOMIZER_TYPES != MAX_TETROMINO_TYPES
+#error "The randomizer must pick from every tetromino type"
+#endif
+
+
+/** Creates a randomizer in the given mode, seeded with seed. */
+randomizer_t randomizer_create(uint32_t seed, randomizer_mode_t mode)
+{
+    randomizer_t randomizer = {
+        .mode = mode
+    };
+
+    randomizer_seed(&randomizer, seed);
+
+    return randomizer;
+}
+
+
+/**
+    Starts the randomizer over from seed, keeping its mode. The seed is mixed so that neighbouring
+    seeds give unrelated sequences, and the bag and history are emptied. The history starts full of
+    s and z tetrominos, so the first few picks are unlikely to be them.
+*/
+void randomizer_seed(randomizer_t* randomizer, uint32_t seed)
+{
+    uint8_t i;
+
+    seed *= 0x9e3779b9;
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6b;
+    seed ^= seed >> 13;
+
+    randomizer->state = seed ? seed : 1;
+    randomizer->bag_count = 0;
+
+    for (i = 0; i < RANDOMIZER_HISTORY_SIZE; i++)
+        randomizer->history[i] = i % 2 ? TETROMINO_TYPE_S : TETROMINO_TYPE_Z;
+}
+
+
+/** Steps the xorshift sequence and returns its new value. */
+static uint32_t randomizer_step(randomizer_t* randomizer)
+{
+    randomizer->state ^= randomizer->state << 13;
+    randomizer->state ^= randomizer->state >> 17;
+    randomizer->state ^= randomizer->state << 5;
+
+    return randomizer->state;
+}
+
+
+/** Returns a number in the range 0 to count - 1, each equally likely. Values past the last whole multiple of count are drawn again. */
+static uint8_t randomizer_below(randomizer_t* randomizer, uint8_t count)
+{
+    uint32_t limit = UINT32_MAX - UINT32_MAX % count;
+    uint32_t value;
+
+    do {
+        value = randomizer_step(randomizer);
+    } while (value >= limit);
+
+    return value % count;
+}
+
+
+/** Deals the next type from the bag, refilling and shuffling the bag once it is empty. */
+static uint8_t randomizer_next_bag(randomizer_t* randomizer)
+{
+    uint8_t swap;
+    uint8_t i;
+    uint8_t j;
+
+    if (randomizer->bag_count == 0) {
+        for (i = 0; i < RANDOMIZER_TYPES; i++)
+            randomizer->bag[i] = i;
+
+        // Fisher-Yates shuffle
+        for (i = RANDOMIZER_TYPES - 1; i > 0; i--) {
+            j = randomizer_below(randomizer, i + 1);
+            swap = randomizer->bag[i];
+            randomizer->bag[i] = randomizer->bag[j];
+            randomizer->bag[j] = swap;
+        }
+
+        randomizer->bag_count = RANDOMIZER_TYPES;
+    }
+
+    return randomizer->bag[--randomizer->bag_count];
+}
+
+
+/** Returns true if the type is one of the last types picked. */
+static bool randomizer_in_history(randomizer_t* randomizer, uint8_t type)
+{
+    uint8_t i;
+
+    for (i = 0; i < RANDOMIZER_HISTORY_SIZE; i++) {
+        if (randomizer->history[i] == type) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/** Picks a type, rerolling up to RANDOMIZER_HISTORY_TRIES times while it is in the history, then remembers it. */
+static uint8_t randomizer_next_history(randomizer_t* randomizer)
+{
+    uint8_t type = randomizer_below(randomizer, RANDOMIZER_TYPES);
+    uint8_t i;
+
+    for (i = 1; i < RANDOMIZER_HISTORY_TRIES && randomizer_in_history(randomizer, type); i++) {
+        type = randomizer_below(randomizer, RANDOMIZER_TYPES);
+    }
+
+    for (i = RANDOMIZER_HISTORY_SIZE - 1; i > 0; i--)
+        randomizer->history[i] = randomizer->history[i - 1];
+    randomizer->history[0] = type;
+
+    return type;
+}
+
+
+/** Returns the next type, in the range 0 to RANDOMIZER_TYPES - 1. */
+uint8_t randomizer_next(randomizer_t* randomizer)
+{
+    switch (randomizer->mode) {
+        case RANDOMIZER_MODE_BAG:
+            return randomizer_next_bag(randomizer);
+        case RANDOMIZER_MODE_HISTORY:
+            return randomizer_next_history(randomizer);
+        default:
+            return randomizer_below(randomizer, RANDOMIZER_TYPES);
+    }
+}
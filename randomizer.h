@@ -0,0 +1,57 @@
+/**
+    @file   randomizer.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Chooses the type of each new tetromino from a seed, so the same seed always gives the same sequence.
+
+    The randomizer has three modes:
+     - RANDOMIZER_MODE_RANDOM picks every type with equal chance, with no memory of earlier picks.
+     - RANDOMIZER_MODE_BAG deals the 7 types in a shuffled order, then shuffles them again, so a type
+       is never more than 12 tetrominos away.
+     - RANDOMIZER_MODE_HISTORY remembers the last 4 types and rerolls a few times when a pick is one
+       of them, which makes repeats rare without fixing the order.
+*/
+
+#ifndef H_RANDOMIZER
+#define H_RANDOMIZER
+
+#include "system.h"
+
+/** The number of types picked from, one for each tetromino type. */
+#define RANDOMIZER_TYPES 7
+
+#define RANDOMIZER_HISTORY_SIZE 4
+#define RANDOMIZER_HISTORY_TRIES 4
+
+/** The ways a randomizer can pick the next type. */
+typedef enum {
+    RANDOMIZER_MODE_RANDOM,
+    RANDOMIZER_MODE_BAG,
+    RANDOMIZER_MODE_HISTORY
+} randomizer_mode_t;
+
+/**
+    The state of a randomizer.
+     - The mode sets how the next type is picked.
+     - The state is an xorshift sequence, every pick is taken from it.
+     - The bag holds the types still to be dealt in bag mode, bag_count of them.
+     - The history holds the last types picked in history mode, the newest first.
+*/
+typedef struct {
+    uint8_t mode;
+    uint32_t state;
+    uint8_t bag[RANDOMIZER_TYPES];
+    uint8_t bag_count;
+    uint8_t history[RANDOMIZER_HISTORY_SIZE];
+} randomizer_t;
+
+/** Creates a randomizer in the given mode, seeded with seed. */
+randomizer_t randomizer_create(uint32_t seed, randomizer_mode_t mode);
+
+/** Starts the randomizer over from seed, keeping its mode. */
+void randomizer_seed(randomizer_t* randomizer, uint32_t seed);
+
+/** Returns the next type, in the range 0 to RANDOMIZER_TYPES - 1. */
+uint8_t randomizer_next(randomizer_t* randomizer);
+
+#endif
@@ -0,0 +1,271 @@
+/**
+    @file   replay.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Records the inputs of a game as a compact binary replay, and plays replays back through the game.
+*/
+
+#include <string.h>
+#include "replay.h"
+#include "game.h"
+
+
+/** Creates a recorder that hands its bytes to write, called with context. */
+replay_recorder_t replay_recorder_create(replay_write_t write, void* context)
+{
+    replay_recorder_t recorder = {
+        .write = write,
+        .context = context
+    };
+
+    return recorder;
+}
+
+
+/** Writes out the bytes in the buffer and empties it. */
+static void replay_flush(replay_recorder_t* recorder)
+{
+    if (recorder->size) {
+        recorder->write(recorder->context, recorder->buffer, recorder->size);
+        recorder->size = 0;
+    }
+}
+
+
+/** Makes room in the buffer for the largest record. */
+static void replay_reserve(replay_recorder_t* recorder)
+{
+    if (recorder->size + REPLAY_RECORD_MAX > REPLAY_BUFFER_SIZE) {
+        replay_flush(recorder);
+    }
+}
+
+
+/** Puts a byte in the buffer, which must have room for it. */
+static void replay_put(replay_recorder_t* recorder, uint8_t byte)
+{
+    recorder->buffer[recorder->size++] = byte;
+}
+
+
+/** Puts a 32 bit number in the buffer, low byte first. */
+static void replay_put_u32(replay_recorder_t* recorder, uint32_t value)
+{
+    uint8_t i;
+
+    for (i = 0; i < 4; i++) {
+        replay_put(recorder, value >> (8 * i));
+    }
+}
+
+
+/** Puts the steps since the previous record in the buffer, 7 bits per byte with the top bit set on all but the last. */
+static void replay_put_steps(replay_recorder_t* recorder, uint32_t tick)
+{
+    uint32_t steps = tick - recorder->tick;
+
+    while (steps >= 0x80) {
+        replay_put(recorder, (steps & 0x7f) | 0x80);
+        steps >>= 7;
+    }
+    replay_put(recorder, steps);
+
+    recorder->tick = tick;
+}
+
+
+/** Starts recording a game that starts at the game tick start, writing the header. */
+void replay_record_start(replay_recorder_t* recorder, uint32_t start, const replay_header_t* header)
+{
+    uint8_t i;
+
+    recorder->size = 0;
+    recorder->tick = start;
+    recorder->recording = true;
+
+    for (i = 0; i < REPLAY_MAGIC_SIZE; i++)
+        replay_put(recorder, REPLAY_MAGIC[i]);
+
+    replay_put(recorder, header->width);
+    replay_put(recorder, header->height);
+    replay_put(recorder, header->mode);
+    replay_put_u32(recorder, header->seed);
+    replay_put(recorder, header->das);
+    replay_put(recorder, header->arr);
+    replay_put(recorder, header->soft_drop);
+    replay_put(recorder, header->line_clear);
+}
+
+
+/** Records the input given to the game step at the game tick tick. Nothing is recorded if the input is empty. */
+void replay_record_input(replay_recorder_t* recorder, uint32_t tick, uint8_t input)
+{
+    if (!recorder->recording || input == GAME_INPUT_NONE) {
+        return;
+    }
+
+    replay_reserve(recorder);
+    replay_put_steps(recorder, tick);
+    replay_put(recorder, input);
+}
+
+
+/** Ends the recording at the game tick tick with the hash of the tetrion, and writes out the buffer. */
+void replay_record_end(replay_recorder_t* recorder, uint32_t tick, uint32_t hash)
+{
+    if (!recorder->recording) {
+        return;
+    }
+
+    replay_reserve(recorder);
+    replay_put_steps(recorder, tick);
+    replay_put(recorder, GAME_INPUT_NONE);
+    replay_put_u32(recorder, hash);
+    replay_flush(recorder);
+
+    recorder->recording = false;
+}
+
+
+/** Creates a reader of the size bytes at data. */
+replay_reader_t replay_reader_create(const uint8_t* data, size_t size)
+{
+    replay_reader_t reader = {
+        .data = data,
+        .size = size,
+        .offset = 0
+    };
+
+    return reader;
+}
+
+
+/** Reads a 32 bit number, low byte first. Returns false if the replay ends first. */
+static bool replay_get_u32(replay_reader_t* reader, uint32_t* value)
+{
+    uint8_t i;
+
+    if (reader->size - reader->offset < 4) {
+        return false;
+    }
+
+    *value = 0;
+    for (i = 0; i < 4; i++) {
+        *value |= (uint32_t) reader->data[reader->offset++] << (8 * i);
+    }
+
+    return true;
+}
+
+
+/** Reads the header of a replay, returns false if it is not a replay. */
+bool replay_read_header(replay_reader_t* reader, replay_header_t* header)
+{
+    if (reader->size - reader->offset < REPLAY_HEADER_SIZE
+        || memcmp(reader->data + reader->offset, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) != 0) {
+        return false;
+    }
+
+    reader->offset += REPLAY_MAGIC_SIZE;
+    header->width = reader->data[reader->offset++];
+    header->height = reader->data[reader->offset++];
+    header->mode = reader->data[reader->offset++];
+    replay_get_u32(reader, &header->seed);
+    header->das = reader->data[reader->offset++];
+    header->arr = reader->data[reader->offset++];
+    header->soft_drop = reader->data[reader->offset++];
+    header->line_clear = reader->data[reader->offset++];
+
+    return true;
+}
+
+
+/**
+    Reads the next record into the steps since the previous record and its input, which is 0 for the
+    end record, whose hash is read as well. Returns false if the replay ends part way through a record.
+*/
+bool replay_read_record(replay_reader_t* reader, uint32_t* steps, uint8_t* input, uint32_t* hash)
+{
+    uint8_t shift = 0;
+    uint8_t byte;
+
+    *steps = 0;
+    do {
+        if (reader->offset >= reader->size || shift > 28) {
+            return false;
+        }
+        byte = reader->data[reader->offset++];
+        *steps |= (uint32_t) (byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    if (reader->offset >= reader->size) {
+        return false;
+    }
+    *input = reader->data[reader->offset++];
+
+    return *input != GAME_INPUT_NONE || replay_get_u32(reader, hash);
+}
+
+
+/**
+    Plays a replay held in memory back through the game, as fast as possible, and checks that the
+    tetrion ends with the recorded hash. The steps played are written to steps if it is not NULL.
+    Each record's input is given to the step it was recorded at, and the steps between get no input.
+    The game's recorder is left empty, so playing a replay never records one.
+*/
+replay_status_t replay_play(const uint8_t* data, size_t size, uint32_t* steps)
+{
+    replay_reader_t reader = replay_reader_create(data, size);
+    replay_header_t header;
+    game_data_t game_data;
+    uint32_t record_steps;
+    uint32_t hash = 0;
+    uint32_t tick = 0;
+    uint8_t input = GAME_INPUT_NONE;
+
+    if (!replay_read_header(&reader, &header)) {
+        return REPLAY_BAD_FORMAT;
+    }
+
+    if (header.width != TETRION_WIDTH || header.height != TETRION_HEIGHT) {
+        return REPLAY_BAD_TETRION;
+    }
+
+    game_data = game_create(header.seed, header.mode);
+    game_data.handling.das = header.das;
+    game_data.handling.arr = header.arr;
+    game_data.handling.soft_drop = header.soft_drop;
+    game_data.handling.line_clear = header.line_clear;
+    game_start(&game_data);
+
+    while (true) {
+        if (!replay_read_record(&reader, &record_steps, &input, &hash)) {
+            return REPLAY_BAD_FORMAT;
+        }
+
+        if (input == GAME_INPUT_NONE) {
+            break;
+        }
+
+        if (record_steps == 0) {
+            return REPLAY_BAD_FORMAT;
+        }
+
+        for (; record_steps > 1; record_steps--, tick++)
+            game_step(&game_data, GAME_INPUT_NONE);
+
+        game_step(&game_data, input);
+        tick++;
+    }
+
+    // the end record can come some steps after the last input, or on the same step
+    for (; record_steps > 0; record_steps--, tick++)
+        game_step(&game_data, GAME_INPUT_NONE);
+
+    if (steps) {
+        *steps = tick;
+    }
+
+    return tetrion_hash(&game_data.tetrion) == hash ? REPLAY_OK : REPLAY_MISMATCH;
+}
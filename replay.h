@@ -0,0 +1,112 @@
+/**
+    @file   replay.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Records the inputs of a game as a compact binary replay, and plays replays back through the game.
+
+    A game is fully decided by its randomizer seed and mode and the inputs given to each game step,
+    so that is all a replay holds:
+     - a header of the magic "TRP3", the tetrion width and height, the randomizer mode, the seed and
+       the handling's delayed auto shift, auto repeat rate, soft drop and line clear,
+     - one record per step that had input, the steps since the previous record as a variable length
+       number (7 bits per byte, low bits first) followed by the input byte,
+     - an end record, the steps since the previous record followed by a 0 input byte, and then the
+       hash of the tetrion when the recording ended.
+    Numbers wider than a byte are little endian, and steps are counted from the start of the game.
+
+    The recorder keeps only a small buffer, which it hands to a write function whenever it fills, so
+    a recording of any length takes the same memory.
+*/
+
+#ifndef H_REPLAY
+#define H_REPLAY
+
+#include <stddef.h>
+#include "system.h"
+
+#define REPLAY_MAGIC "TRP3"
+#define REPLAY_MAGIC_SIZE 4
+#define REPLAY_HEADER_SIZE (REPLAY_MAGIC_SIZE + 3 + 4 + 4)
+
+/** The most bytes a record can take, a 5 byte step count, the input and the 4 byte hash of an end record. */
+#define REPLAY_RECORD_MAX 10
+
+#define REPLAY_BUFFER_SIZE 64
+
+/** Takes the next bytes of a recording, for example to write them to a file. */
+typedef void (*replay_write_t)(void* context, const uint8_t* bytes, uint16_t size);
+
+/**
+    A recording in progress.
+     - The write function and its context take the bytes as the buffer fills.
+     - The buffer holds the bytes not yet written, size of them.
+     - The tick is the game tick of the last record, or of the start of the game.
+     - Recording is true between the start and the end of a game.
+*/
+typedef struct {
+    replay_write_t write;
+    void* context;
+    uint8_t buffer[REPLAY_BUFFER_SIZE];
+    uint16_t size;
+    uint32_t tick;
+    bool recording;
+} replay_recorder_t;
+
+/** The header of a replay, everything needed to start the game over. */
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+    uint8_t mode;
+    uint32_t seed;
+    uint8_t das;
+    uint8_t arr;
+    uint8_t soft_drop;
+    uint8_t line_clear;
+} replay_header_t;
+
+/** Reads a replay held in memory, the offset is the next byte to read. */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+} replay_reader_t;
+
+/** The results of a replay check. */
+typedef enum {
+    REPLAY_OK,
+    REPLAY_BAD_FORMAT,
+    REPLAY_BAD_TETRION,
+    REPLAY_MISMATCH
+} replay_status_t;
+
+/** Creates a recorder that hands its bytes to write, called with context. */
+replay_recorder_t replay_recorder_create(replay_write_t write, void* context);
+
+/** Starts recording a game that starts at the game tick start, writing the header. */
+void replay_record_start(replay_recorder_t* recorder, uint32_t start, const replay_header_t* header);
+
+/** Records the input given to the game step at the game tick tick. Nothing is recorded if the input is empty. */
+void replay_record_input(replay_recorder_t* recorder, uint32_t tick, uint8_t input);
+
+/** Ends the recording at the game tick tick with the hash of the tetrion, and writes out the buffer. */
+void replay_record_end(replay_recorder_t* recorder, uint32_t tick, uint32_t hash);
+
+/** Creates a reader of the size bytes at data. */
+replay_reader_t replay_reader_create(const uint8_t* data, size_t size);
+
+/** Reads the header of a replay, returns false if it is not a replay. */
+bool replay_read_header(replay_reader_t* reader, replay_header_t* header);
+
+/**
+    Reads the next record into the steps since the previous record and its input, which is 0 for the
+    end record, whose hash is read as well. Returns false if the replay ends part way through a record.
+*/
+bool replay_read_record(replay_reader_t* reader, uint32_t* steps, uint8_t* input, uint32_t* hash);
+
+/**
+    Plays a replay held in memory back through the game, as fast as possible, and checks that the
+    tetrion ends with the recorded hash. The steps played are written to steps if it is not NULL.
+*/
+replay_status_t replay_play(const uint8_t* data, size_t size, uint32_t* steps);
+
+#endif
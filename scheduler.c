@@ -0,0 +1,218 @@
+/**
+    @file   scheduler.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Runs tasks in order of when they are due, sleeping until the next one.
+*/
+
+#include "hal.h"
+#include "scheduler.h"
+
+#define SCHEDULER_NONE UINT8_MAX
+
+
+/** Returns true if time a comes before time b, allowing for the clock wrapping around. */
+static bool scheduler_before(scheduler_tick_t a, scheduler_tick_t b)
+{
+    return (scheduler_tick_t) (a - b) > (scheduler_tick_t) ~0 >> 1;
+}
+
+
+/** Returns true if the task at heap position i is due before the one at position j. */
+static bool scheduler_heap_less(scheduler_t* scheduler, uint8_t i, uint8_t j)
+{
+    return scheduler_before(scheduler->tasks[scheduler->heap[i]].deadline, scheduler->tasks[scheduler->heap[j]].deadline);
+}
+
+
+/** Swaps two positions of the heap. */
+static void scheduler_heap_swap(scheduler_t* scheduler, uint8_t i, uint8_t j)
+{
+    uint8_t task = scheduler->heap[i];
+
+    scheduler->heap[i] = scheduler->heap[j];
+    scheduler->heap[j] = task;
+}
+
+
+/** Moves the task at heap position i up until its parent is due no later than it. */
+static void scheduler_sift_up(scheduler_t* scheduler, uint8_t i)
+{
+    uint8_t parent;
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!scheduler_heap_less(scheduler, i, parent)) {
+            break;
+        }
+        scheduler_heap_swap(scheduler, i, parent);
+        i = parent;
+    }
+}
+
+
+/** Moves the task at heap position i down until its children are due no earlier than it. */
+static void scheduler_sift_down(scheduler_t* scheduler, uint8_t i)
+{
+    uint8_t child;
+
+    while ((child = 2 * i + 1) < scheduler->heap_size) {
+        if (child + 1 < scheduler->heap_size && scheduler_heap_less(scheduler, child + 1, child)) {
+            child++;
+        }
+        if (!scheduler_heap_less(scheduler, child, i)) {
+            break;
+        }
+        scheduler_heap_swap(scheduler, i, child);
+        i = child;
+    }
+}
+
+
+/** Puts a task on the heap. */
+static void scheduler_heap_push(scheduler_t* scheduler, uint8_t task)
+{
+    scheduler->heap[scheduler->heap_size] = task;
+    scheduler_sift_up(scheduler, scheduler->heap_size++);
+}
+
+
+/** Takes the task at heap position i off the heap. */
+static void scheduler_heap_remove(scheduler_t* scheduler, uint8_t i)
+{
+    scheduler->heap[i] = scheduler->heap[--scheduler->heap_size];
+
+    if (i < scheduler->heap_size) {
+        scheduler_sift_up(scheduler, i);
+        scheduler_sift_down(scheduler, i);
+    }
+}
+
+
+/** Sets up the scheduler with the tasks, each enabled one due when the scheduler starts. */
+void scheduler_init(scheduler_t* scheduler, scheduler_task_t* tasks, uint8_t num_tasks)
+{
+    uint8_t i;
+
+    scheduler->tasks = tasks;
+    scheduler->num_tasks = num_tasks;
+    scheduler->heap_size = 0;
+    scheduler->running = SCHEDULER_NONE;
+    scheduler->wakeups = 0;
+
+    for (i = 0; i < num_tasks; i++) {
+        tasks[i].deadline = 0;
+        tasks[i].runs = 0;
+        if (tasks[i].enabled) {
+            scheduler_heap_push(scheduler, i);
+        }
+    }
+}
+
+
+/** Runs the tasks as they come due, for ever on the board. */
+void scheduler_run(scheduler_t* scheduler)
+{
+    uint16_t seconds = hal_run_seconds();
+    uint16_t elapsed = 0;
+    scheduler_tick_t second;
+    scheduler_tick_t now;
+    scheduler_task_t* task;
+    uint8_t i;
+
+    timer_init();
+    now = timer_get();
+    second = now;
+
+    // all the enabled tasks are due now, which keeps the heap in order
+    for (i = 0; i < scheduler->num_tasks; i++)
+        scheduler->tasks[i].deadline = now;
+
+    while (seconds == 0 || elapsed < seconds) {
+        if (scheduler->heap_size == 0) {
+            hal_sleep_until(timer_get() + SCHEDULER_RATE);
+            now = timer_get();
+        } else {
+            scheduler->running = scheduler->heap[0];
+            task = &scheduler->tasks[scheduler->running];
+            scheduler_heap_remove(scheduler, 0);
+
+            now = timer_get();
+            if (scheduler_before(now, task->deadline)) {
+                hal_sleep_until(task->deadline);
+                scheduler->wakeups++;
+                now = task->deadline;
+            }
+
+            task->runs++;
+            hal_task_run(task->func, task->data);
+
+            if (task->enabled) {
+                task->deadline += task->period;
+                scheduler_heap_push(scheduler, scheduler->running);
+            }
+            scheduler->running = SCHEDULER_NONE;
+        }
+
+        while ((scheduler_tick_t) (now - second) >= SCHEDULER_RATE) {
+            second += SCHEDULER_RATE;
+            elapsed++;
+        }
+    }
+}
+
+
+/** Makes a disabled task due now. */
+void scheduler_task_enable(scheduler_t* scheduler, uint8_t task)
+{
+    if (scheduler->tasks[task].enabled) {
+        return;
+    }
+
+    scheduler->tasks[task].enabled = true;
+
+    if (task != scheduler->running) {
+        scheduler->tasks[task].deadline = timer_get();
+        scheduler_heap_push(scheduler, task);
+    }
+}
+
+
+/** Stops a task from running until it is enabled again. */
+void scheduler_task_disable(scheduler_t* scheduler, uint8_t task)
+{
+    uint8_t i;
+
+    if (!scheduler->tasks[task].enabled) {
+        return;
+    }
+
+    scheduler->tasks[task].enabled = false;
+
+    for (i = 0; i < scheduler->heap_size; i++) {
+        if (scheduler->heap[i] == task) {
+            scheduler_heap_remove(scheduler, i);
+            break;
+        }
+    }
+}
+
+
+/** Changes the period of a task, from its next run. */
+void scheduler_task_set_period(scheduler_t* scheduler, uint8_t task, scheduler_tick_t period)
+{
+    scheduler->tasks[task].period = period;
+}
+
+
+/** Returns the total number of runs of all the tasks. */
+uint32_t scheduler_dispatches(scheduler_t* scheduler)
+{
+    uint32_t dispatches = 0;
+    uint8_t i;
+
+    for (i = 0; i < scheduler->num_tasks; i++)
+        dispatches += scheduler->tasks[i].runs;
+
+    return dispatches;
+}
@@ -0,0 +1,72 @@
+/**
+    @file   scheduler.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Runs tasks in order of when they are due, sleeping until the next one.
+
+    The enabled tasks are kept in a min-heap ordered by their deadline, the time they are next due.
+    The scheduler takes the earliest task off the heap, sleeps until it is due unless it is already,
+    runs it, and puts it back due a period after its previous deadline, so late runs do not put off
+    the ones after them. A disabled task is not on the heap, so it costs nothing until it is enabled.
+
+    A task can disable itself or change its period while it runs, and any task can enable or change
+    another. A new period takes effect from the task's next run.
+
+    On the board the scheduler never returns. On the host it returns after the run time hal.h gives.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "system.h"
+#include "timer.h"
+
+#define SCHEDULER_RATE TIMER_RATE
+#define SCHEDULER_TASKS_MAX 8
+
+typedef timer_tick_t scheduler_tick_t;
+
+typedef void (*scheduler_func_t)(void* data);
+
+/** A task, which is due at its deadline while it is enabled, and the number of times it has run. */
+typedef struct {
+    scheduler_func_t func;
+    void* data;
+    scheduler_tick_t period;
+    scheduler_tick_t deadline;
+    uint32_t runs;
+    bool enabled;
+} scheduler_task_t;
+
+/**
+    The tasks, the heap of the enabled ones by index, the task being run, which is off the heap
+    until it is put back after its run, and the number of times the scheduler slept and woke up.
+*/
+typedef struct {
+    scheduler_task_t* tasks;
+    uint8_t num_tasks;
+    uint8_t heap[SCHEDULER_TASKS_MAX];
+    uint8_t heap_size;
+    uint8_t running;
+    uint32_t wakeups;
+} scheduler_t;
+
+/** Sets up the scheduler with the tasks, each enabled one due when the scheduler starts. */
+void scheduler_init(scheduler_t* scheduler, scheduler_task_t* tasks, uint8_t num_tasks);
+
+/** Runs the tasks as they come due, for ever on the board. */
+void scheduler_run(scheduler_t* scheduler);
+
+/** Makes a disabled task due now. */
+void scheduler_task_enable(scheduler_t* scheduler, uint8_t task);
+
+/** Stops a task from running until it is enabled again. */
+void scheduler_task_disable(scheduler_t* scheduler, uint8_t task);
+
+/** Changes the period of a task, from its next run. */
+void scheduler_task_set_period(scheduler_t* scheduler, uint8_t task, scheduler_tick_t period);
+
+/** Returns the total number of runs of all the tasks. */
+uint32_t scheduler_dispatches(scheduler_t* scheduler);
+
+#endif
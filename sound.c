@@ -5,6 +5,7 @@
     @brief  Controls the audio used in the tetris game.
 */
 #include "sound.h"
+#include "hal.h"
 #include "mmelody.h"
 #include "pio.h"
 #include "tweeter.h"
@@ -18,7 +19,7 @@
 #define ROTATE_CLOCKWISE_TUNE "D,"
 #define ROTATE_COUNTERCLOCKWISE_TUNE "E,"
 
-static tweeter_scale_t scale_table[] = TWEETER_SCALE_TABLE(TWEETER_TASK_RATE);
+static tweeter_scale_t scale_table[] = TWEETER_SCALE_TABLE(TWEETER_INTERRUPT_RATE);
 static tweeter_t tweeter;
 static mmelody_t melody;
 static mmelody_obj_t melody_info;
@@ -33,26 +34,39 @@ static const char game_over_tune[] = {
 };
 
 
-/** Initializes tweeter pins and melody for tunes. */
-void sound_init(void)
+/** Called by the tweeter interrupt to move the square wave on and drive the piezo with it. */
+static void sound_update_tweeter(void)
 {
-    pio_config_set(PIEZO1_PIO, PIO_OUTPUT_LOW);
-    pio_config_set(PIEZO2_PIO, PIO_OUTPUT_LOW);
+    bool state = tweeter_update(tweeter);
 
-    tweeter = tweeter_init(&tweeter_info, TWEETER_TASK_RATE, scale_table);
-    melody = mmelody_init(&melody_info, TUNE_TASK_RATE, (mmelody_callback_t)tweeter_note_play, tweeter);
+    pio_output_set(PIEZO1_PIO, state);
+    pio_output_set(PIEZO2_PIO, !state);
+}
 
-    mmelody_speed_set(melody, TUNE_BPM_RATE);
+
+/** Called by the melody to play a note, with the tweeter interrupt held off while the note is changed under it. */
+static void sound_note_play(void* data, uint8_t note, uint8_t velocity)
+{
+    uint8_t state = hal_interrupts_disable();
+
+    tweeter_note_play((tweeter_t) data, note, velocity);
+
+    hal_interrupts_restore(state);
 }
 
 
-/** Lets task scheduler check for updates for the tweeter. */
-void sound_update_tweeter(void)
+/** Initializes tweeter pins and melody for tunes, and starts the tweeter interrupt. */
+void sound_init(void)
 {
-    bool state = tweeter_update(tweeter);
+    pio_config_set(PIEZO1_PIO, PIO_OUTPUT_LOW);
+    pio_config_set(PIEZO2_PIO, PIO_OUTPUT_LOW);
 
-    pio_output_set(PIEZO1_PIO, state);
-    pio_output_set(PIEZO2_PIO, !state);
+    tweeter = tweeter_init(&tweeter_info, TWEETER_INTERRUPT_RATE, scale_table);
+    melody = mmelody_init(&melody_info, TUNE_TASK_RATE, sound_note_play, tweeter);
+
+    mmelody_speed_set(melody, TUNE_BPM_RATE);
+
+    hal_audio_start(TWEETER_INTERRUPT_RATE, sound_update_tweeter);
 }
 
 
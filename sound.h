@@ -3,20 +3,20 @@
     @author Vince Alain W. Verwilligen (vav18), Sam Clark (scl113)
     @date   21 October 2021
     @brief  Controls the audio used in the tetris game.
+
+    The tweeter's square wave is made by a timer interrupt at TWEETER_INTERRUPT_RATE, so its pitch
+    does not wobble when a task runs long, while the melody moves on from note to note in a task.
 */
 
 #ifndef SOUND_H
 #define SOUND_H
 
-#define TWEETER_TASK_RATE 10000
+#define TWEETER_INTERRUPT_RATE 10000
 #define TUNE_TASK_RATE 200
 
-/** Initializes tweeter pins and melody for tunes. */
+/** Initializes tweeter pins and melody for tunes, and starts the tweeter interrupt. */
 void sound_init(void);
 
-/** Lets task scheduler check for updates for the tweeter. */
-void sound_update_tweeter(void);
-
 /** Lets task scheduler check for updates for the melody. */
 void sound_update_melody(void);
 
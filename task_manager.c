@@ -5,86 +5,148 @@
     @brief  Runs the tasks required for the tetris game to run.
 */
 
-#include "button.h"
+#include <string.h>
+#include "input.h"
 #include "led.h"
 #include "led_matrix.h"
-#include "navswitch.h"
 #include "pacer.h"
 #include "pio.h"
 #include "sound.h"
 #include "system.h"
-#include "task.h"
+#include "scheduler.h"
 #include "task_manager.h"
 #include "tetromino.h"
 
+#ifdef TASK_STATS
+#include <stdio.h>
+#include "hal.h"
+#include "task_stats.h"
+#ifndef __AVR__
+#include "ledmat.h"
+#endif
+#endif
+
+#if TETRION_WIDTH != TINYGL_WIDTH || TETRION_HEIGHT != TINYGL_HEIGHT
+#error "The display shows the whole tetrion, so it must be the size of the LED matrix"
+#endif
+
 #define DISPLAY_TASK_RATE 300
-#define BUTTON_TASK_RATE 50
+#define DISPLAY_SLOT_PERIOD (SCHEDULER_RATE / DISPLAY_TASK_RATE / LED_MATRIX_SLOTS)
 #define GAME_TASK_RATE 100
-#define DROP_TASK_RATE 100
-#define MOVEMENT_SPEED_INCREASE 10
+#define DROP_TASK_RATE GAME_TICK_RATE
 #define FLASH_LED_RATE 100
 
 #define FLASH_RATE 5
 #define LED_OFF 0
 #define LED_ON 1
 
-#define FLASH_DURATION 20
-#define FLASHING_OFF 0
-#define FLASHING_ON 1
+/** The tasks, in the order of the task list. */
+enum {
+    TASK_TUNE,
+    TASK_DISPLAY,
+    TASK_GAME_INIT,
+    TASK_DROP_TETROMINO,
+    TASK_FLASH_LED,
+    NUM_TASKS
+};
 
+static scheduler_t scheduler;
 
 /**
-    Called when the player either starts a game for the first time or retries after a game is lost,
-    this function clears the tetrion and display, stops the intro music and adds the first tetromino. 
-    The game state is also est to playing so that the tasks can determine the games flow.
- */
-static void game_start(game_data_t* game_data)
+    The frames the game composes and the display task draws, two buffers swapped by pointer. After
+    each step the game composes the whole frame into the back buffer and, only if it differs from
+    the front one, publishes it by swapping the two, so the display task only ever draws complete
+    frames and skips the steps that changed nothing.
+*/
+static led_matrix_frame_t frames[2];
+static led_matrix_frame_t* front_frame = &frames[0];
+static led_matrix_frame_t* back_frame = &frames[1];
+static bool frame_published;
+
+
+/** Returns the brightness of the lines being cleared, fading from full to dim over the line clear. */
+static uint8_t frame_clear_level(game_data_t* game_data)
 {
-    led_matrix_clear();
-    tetrion_clear(&game_data->tetrion);
-    sound_stop_tune();
-    tetrion_try_add_tetromino(&game_data->tetrion);
-    game_data->state = STATE_PLAYING;
+    uint8_t ticks = game_data->handling.line_clear;
+
+    return ((uint16_t) game_data->clear_ticks * LED_MATRIX_LEVEL_MAX + ticks - 1) / ticks;
 }
 
 
 /**
-    Called when the player loses the game, by no longer being able to place a tetromino, this function
-    plays game over tune and shows the game over message, with the players score.
- */
-static void game_over(game_data_t* game_data)
+    Composes the game into the back frame, and publishes it if it differs from the front frame. While
+    playing, the locked pixels and the falling tetromino are at full brightness over its ghost piece
+    dimmed where it would land. While clearing, the full lines fade out and the rest stay at full brightness.
+*/
+static void frame_publish(game_data_t* game_data)
 {
-    sound_play_game_over_tune();
-    led_matrix_clear();
-    led_matrix_display_game_over_and_lines(game_data->message, game_data->tetrion.lines);
-    game_data->state = STATE_OVER;
+    tetrion_t* tetrion = &game_data->tetrion;
+    tetrion_row_t rows[TETRION_HEIGHT];
+    tetrion_row_t lines[TETRION_HEIGHT];
+    led_matrix_frame_t* frame;
+    uint8_t i;
+
+    led_matrix_frame_clear(back_frame);
+    if (game_data->state == STATE_CLEARING) {
+        for (i = 0; i < TETRION_HEIGHT; i++) {
+            lines[i] = game_data->clearing_lines & BIT(i) ? tetrion->rows[i] : 0;
+            rows[i] = tetrion->rows[i] & ~lines[i];
+        }
+        led_matrix_frame_add(back_frame, lines, frame_clear_level(game_data));
+    } else {
+        tetrion_compose_ghost(tetrion, rows);
+        led_matrix_frame_add(back_frame, rows, LED_MATRIX_LEVEL_DIM);
+        tetrion_compose(tetrion, rows);
+    }
+    led_matrix_frame_add(back_frame, rows, LED_MATRIX_LEVEL_MAX);
+
+    if (memcmp(back_frame, front_frame, sizeof(*back_frame)) == 0) {
+        return;
+    }
+
+    frame = front_frame;
+    front_frame = back_frame;
+    back_frame = frame;
+    frame_published = true;
+}
+
+
+/** Fills the front frame with a pattern no composed frame can have, pixels outside the tetrion, so the next frame is always published. */
+static void frame_invalidate(void)
+{
+    memset(front_frame, UINT8_MAX, sizeof(*front_frame));
+    frame_published = false;
 }
 
 
 /**
- * Is called every time the falling tetromino is going to fall.
- * Once the falling tetromino hit bottom, it sticks and a new tetromino will be shown.
- * If the new tetromino is shown on an already existing tetromino, the game is over.
- * This time reduces to make fitting the tetromino harder.
+    Called when the player either starts a game for the first time or retries after a game is lost,
+    this function clears the display, stops the intro music, forgets the held buttons and starts the game, which adds the first tetromino.
+    The game is seeded with the ticks waited for the player to push, so each game gets new tetrominos.
+    The game state is also set to playing so that the tasks can determine the games flow.
  */
-static void tetromino_drop_handle(game_data_t* game_data)
+static void game_start_handle(game_data_t* game_data)
 {
-    if (!tetrion_try_move_down(&game_data->tetrion)) {
-        tetrion_check_lines(&game_data->tetrion);
-
-        if (!tetrion_try_add_tetromino(&game_data->tetrion)) {
-            game_over(game_data);
-        }
-    }
+    led_matrix_clear();
+    frame_invalidate();
+    sound_stop_tune();
+    game_data->seed = game_data->ticks;
+    game_data->held = GAME_INPUT_NONE;
+    game_data->held_shift = GAME_INPUT_NONE;
+    game_start(game_data);
 }
 
 
 /**
- * Updates the tweeter to turn it on.
+    Called when the player loses the game, by no longer being able to place a tetromino, this function
+    plays game over tune and shows the game over message, with the players score.
  */
-static void tweeter_task(__unused__ void* data)
+static void game_over_handle(game_data_t* game_data)
 {
-    sound_update_tweeter();
+    sound_play_game_over_tune();
+    frame_invalidate();
+    led_matrix_clear();
+    led_matrix_display_game_over_and_lines(game_data->message, game_data->tetrion.lines);
 }
 
 
@@ -99,155 +161,141 @@ static void tune_task(__unused__ void* data)
 
 /**
  * Updates all texts or tetrominos to the led matrix display.
+ * While playing, only a frame newly published by a game step is drawn, the game never being read here.
+ * Each run shows a column, or a bit plane of one, and sets the task's period to the slots it is shown for,
+ * so the brightness levels come from the time each plane stays on.
  */
 static void display_task(void* data)
 {
     game_data_t* game_data = (game_data_t*) data;
 
-    if (game_data->state == STATE_PLAYING) {
-        led_matrix_draw(game_data->tetrion.display);
+    if ((game_data->state == STATE_PLAYING || game_data->state == STATE_CLEARING) && frame_published) {
+        led_matrix_draw(front_frame);
+        frame_published = false;
     }
 
-    led_matrix_update();
+    // the step that applied an input either moved the tetromino, drawn above, or ended the game and put up its message
+    input_shown();
+
+    scheduler_task_set_period(&scheduler, TASK_DISPLAY, DISPLAY_SLOT_PERIOD * led_matrix_update());
 }
 
 
 /**
- * Checks for changes of button1
- * Push - rotates falling tetromino counterclockwise and plays a sound.
+ * Is responsible for starting and ending the game.
+ * It is only needed once, so it disables itself when the start message is shown.
  */
-static void button_task(void* data)
+static void game_init_task(void* data)
 {
     game_data_t* game_data = (game_data_t*) data;
-
-    button_update();
-
-    if (button_push_event_p(BUTTON1) && game_data->state == STATE_PLAYING) {
-        tetrion_try_rotate_counterclockwise(&game_data->tetrion);
-        sound_play_rotate_counterclockwise_tune();
+    if (game_data->state == STATE_INIT) {
+        led_matrix_display_start();
+        sound_play_tetris_tune();
+        game_data->state = STATE_READY;
     }
+
+    scheduler_task_disable(&scheduler, TASK_GAME_INIT);
 }
 
 
 /**
- * Checks for changes of the navswitch.
- * Push in not playing state - start a new game.
+ * Takes the pushes and releases queued since the last step off the input queue, in the order they came, and returns the game input for the step.
+ * Push in not playing state - start a new game, the other pushes are dropped.
  * Push in playing state - rotates the falling tetromino clockwise and plays a sound.
- * Left - moves the falling tetromino.
- * Right - move the falling tetromino.
- * Buttom - moves the falling tetromino.
+ * Button1 - rotates the falling tetromino counterclockwise and plays a sound.
+ * Left, right and bottom - move the falling tetromino, and repeat the move while held.
+ * Top - drops the falling tetromino straight down and locks it.
+ * The step applies its inputs in the order of their bits, so a push that would be applied before
+ * one already taken, or twice, is left on the queue for the next step.
+ * A step without a push of left or right holds the one pushed last if it is still held, and the same for down.
+ * While lines are clearing the game takes no input, so the pushes and releases stay queued for the steps after.
  */
-static void navswitch_task(void* data)
+static game_input_t input_gather(game_data_t* game_data)
 {
-    game_data_t* game_data = (game_data_t*) data;
-
-    navswitch_update();
+    game_input_t input = GAME_INPUT_NONE;
+    input_event_t event;
 
-    if (navswitch_push_event_p(NAVSWITCH_PUSH) && (game_data->state == STATE_READY || game_data->state == STATE_OVER)) {
-       game_start(game_data);
+    if (game_data->state == STATE_CLEARING) {
+        return input;
     }
 
-    if(game_data->state == STATE_PLAYING) {
-
-        if (navswitch_push_event_p(NAVSWITCH_PUSH)) {
-            tetrion_try_rotate_clockwise(&game_data->tetrion);
-            sound_play_rotate_clockwise_tune();
-        }
-
-        if (navswitch_push_event_p(NAVSWITCH_SOUTH)) {
-            tetrion_try_move_down(&game_data->tetrion);
+    while (input_peek(&event)) {
+        if (event.released) {
+            game_data->held &= ~event.input;
+        } else if (game_data->state == STATE_PLAYING) {
+            if (event.input <= input) {
+                break;
+            }
+            input |= event.input;
+            game_data->held |= event.input & GAME_INPUT_REPEATING;
+            if (event.input & (GAME_INPUT_LEFT | GAME_INPUT_RIGHT)) {
+                game_data->held_shift = event.input;
+            }
+            input_applied(event.time);
+        } else if (event.input == GAME_INPUT_ROTATE_CLOCKWISE && (game_data->state == STATE_READY || game_data->state == STATE_OVER)) {
+            game_start_handle(game_data);
         }
+        input_pop();
+    }
 
-        if (navswitch_push_event_p(NAVSWITCH_WEST)) {
-            tetrion_try_move_left(&game_data->tetrion);
+    if (game_data->state == STATE_PLAYING) {
+        if (!(input & (GAME_INPUT_LEFT | GAME_INPUT_RIGHT)) && (game_data->held & game_data->held_shift)) {
+            input |= GAME_INPUT_HOLD_SHIFT;
         }
-
-        if (navswitch_push_event_p(NAVSWITCH_EAST)) {
-            tetrion_try_move_right(&game_data->tetrion);
+        if (!(input & GAME_INPUT_DOWN) && (game_data->held & GAME_INPUT_DOWN)) {
+            input |= GAME_INPUT_HOLD_DOWN;
         }
     }
-}
-
 
-/**
- * Is responsible for starting and ending the game.
- */
-static void game_init_task(void* data)
-{
-    game_data_t* game_data = (game_data_t*) data;
-    if (game_data->state == STATE_INIT) {
-        led_matrix_display_start();
-        sound_play_tetris_tune();
-        game_data->state = STATE_READY;
+    if (input & GAME_INPUT_ROTATE_CLOCKWISE) {
+        sound_play_rotate_clockwise_tune();
+    } else if (input & GAME_INPUT_ROTATE_COUNTERCLOCKWISE) {
+        sound_play_rotate_counterclockwise_tune();
     }
+
+    return input;
 }
 
 
 /**
- * A timer is used to count ticks, which is used for the falling block and the randomness of new tetromino.
+ * Steps the game with the pushes queued since the last step, which drops the falling tetromino when its time has come,
+ * and publishes the frame it leaves for the display task. Full lines start the LED flashing task.
  */
 static void drop_tetromino_task(void* data)
 {
     game_data_t* game_data = (game_data_t*) data;
+    game_event_t events;
 
-    static uint8_t level;
-    static uint8_t drop_rate;
-    static uint16_t tetrion_ticks;
-    static uint16_t random_ticks;
+    events = game_step(game_data, input_gather(game_data));
 
-    level = game_data->tetrion.lines / MOVEMENT_SPEED_INCREASE;
-    drop_rate = (DROP_TASK_RATE - (MOVEMENT_SPEED_INCREASE * level));
-    if (game_data->state == STATE_PLAYING && tetrion_ticks % drop_rate == 0) {
-        tetromino_drop_handle(game_data);
-        tetrion_ticks = 0;
+    if (events & GAME_EVENT_LINES) {
+        scheduler_task_enable(&scheduler, TASK_FLASH_LED);
     }
 
-    game_data->tetrion.random_ticks = random_ticks;
-
-    tetrion_ticks++;
-    random_ticks++;
+    if (events & GAME_EVENT_OVER) {
+        game_over_handle(game_data);
+    } else if (game_data->state == STATE_PLAYING || game_data->state == STATE_CLEARING) {
+        frame_publish(game_data);
+    }
 }
 
 
 /**
-    Responsible for flashing the blue LED whenever a line is removed from the tetrion
+    Responsible for flashing the blue LED while full lines are being cleared, toggling it every
+    FLASH_RATE ticks of the line clear. It is enabled when full lines are made, and turns the LED
+    off and disables itself once the game is no longer clearing them.
 */
 static void flash_led_task(void* data)
 {
     game_data_t* game_data = (game_data_t*) data;
-    
-    static uint8_t lines;
-    static uint16_t led_flashing_ticks;
-
-    static uint16_t led_ticks;
-    static bool flashing = FLASHING_OFF;
-    static bool led_state = LED_OFF;
-
-    if (game_data->state == STATE_PLAYING) {
 
-        // Start flashing LED
-        if (flashing == FLASHING_OFF && game_data->tetrion.lines > lines) {
-            flashing = FLASHING_ON;
-            led_ticks = 0;
-            lines = game_data->tetrion.lines;
-        }
-
-        // Stop LED from flashing
-        if (flashing == FLASHING_ON && led_ticks > FLASH_DURATION) {
-            flashing = FLASHING_OFF;
-            led_set(LED1, LED_OFF);
-        }
-
-        // Flashing LED
-        if (flashing == FLASHING_ON && led_ticks % FLASH_RATE == 0) {
-            led_set(LED1, led_state);
-            led_state = !led_state;
-            led_flashing_ticks = 0;
-        }
+    if (game_data->state != STATE_CLEARING) {
+        led_set(LED1, LED_OFF);
+        scheduler_task_disable(&scheduler, TASK_FLASH_LED);
+        return;
     }
 
-    led_ticks++;
-    led_flashing_ticks++;
+    led_set(LED1, (game_data->clear_ticks / FLASH_RATE) % 2 ? LED_OFF : LED_ON);
 }
 
 
@@ -258,23 +306,78 @@ void task_manager_run(game_data_t* game_data) {
 
     system_init();
     sound_init();
-    button_init();
-    navswitch_init();
+    input_init();
     led_matrix_init(DISPLAY_TASK_RATE);
     led_init();
     led_set(LED1, LED_OFF);
 
-    task_t tasks[] = {
-
-        { .func = tweeter_task, .period = TASK_RATE / TWEETER_TASK_RATE, .data = game_data },
-        { .func = tune_task, .period = TASK_RATE / TUNE_TASK_RATE, .data = game_data },
-        { .func = display_task, .period = TASK_RATE / DISPLAY_TASK_RATE, .data = game_data },
-        { .func = navswitch_task, .period = TASK_RATE / BUTTON_TASK_RATE, .data = game_data },
-        { .func = button_task, .period = TASK_RATE / BUTTON_TASK_RATE, .data = game_data },
-        { .func = game_init_task, .period = TASK_RATE / GAME_TASK_RATE, .data = game_data },
-        { .func = drop_tetromino_task, .period = TASK_RATE / DROP_TASK_RATE, .data = game_data },
-        { .func = flash_led_task, .period = TASK_RATE / FLASH_LED_RATE, .data = game_data } 
+    static scheduler_task_t tasks[NUM_TASKS] = {
+        [TASK_TUNE] = { .func = tune_task, .period = SCHEDULER_RATE / TUNE_TASK_RATE, .enabled = true },
+        [TASK_DISPLAY] = { .func = display_task, .period = SCHEDULER_RATE / DISPLAY_TASK_RATE, .enabled = true },
+        [TASK_GAME_INIT] = { .func = game_init_task, .period = SCHEDULER_RATE / GAME_TASK_RATE, .enabled = true },
+        [TASK_DROP_TETROMINO] = { .func = drop_tetromino_task, .period = SCHEDULER_RATE / DROP_TASK_RATE, .enabled = true },
+        [TASK_FLASH_LED] = { .func = flash_led_task, .period = SCHEDULER_RATE / FLASH_LED_RATE, .enabled = false }
     };
+    uint8_t i;
+
+    for (i = 0; i < NUM_TASKS; i++)
+        tasks[i].data = game_data;
 
-    task_schedule(tasks, ARRAY_SIZE(tasks));
+#ifdef TASK_STATS
+    static const char* const task_names[] = {
+        "tune_task", "display_task", "game_init_task", "drop_tetromino_task", "flash_led_task"
+    };
+    static task_stats_t task_stats[NUM_TASKS];
+    char line[TASK_STATS_LINE_SIZE];
+    input_stats_t input;
+    uint32_t late_max;
+    uint32_t calls;
+#ifndef __AVR__
+    uint8_t column;
+    uint8_t row;
+    int length;
+#endif
+
+    task_stats_wrap(tasks, task_stats, NUM_TASKS);
+#endif
+
+    scheduler_init(&scheduler, tasks, NUM_TASKS);
+    scheduler_run(&scheduler);
+
+#ifdef TASK_STATS
+    // only the host scheduler returns, on the board the table can be dumped from a debugger
+    task_stats_dump(task_stats, task_names, NUM_TASKS, hal_console_write);
+
+    snprintf(line, sizeof(line), "scheduler: %lu wakeups, %lu dispatches\n",
+        (unsigned long) scheduler.wakeups, (unsigned long) scheduler_dispatches(&scheduler));
+    hal_console_write(line);
+
+    input = input_stats();
+    snprintf(line, sizeof(line), "input: %lu events, %lu dropped, latency to the display mean %lu max %lu us\n",
+        (unsigned long) input.events, (unsigned long) input.dropped,
+        (unsigned long) (input.shown ? (uint64_t) input.latency_total * 1000000 / TIMER_RATE / input.shown : 0),
+        (unsigned long) ((uint64_t) input.latency_max * 1000000 / TIMER_RATE));
+    hal_console_write(line);
+
+    calls = hal_audio_stats(&late_max);
+    snprintf(line, sizeof(line), "tweeter interrupt: %lu calls, lateness max %lu cycles\n", (unsigned long) calls, (unsigned long) late_max);
+    hal_console_write(line);
+
+#ifndef __AVR__
+    // the LED matrix stand-in records how long each cell was lit, which the board has no way to
+    snprintf(line, sizeof(line), "display: %lu column refreshes, longest between showings of a column %lu us, duty cycle of each cell in %%:\n",
+        (unsigned long) ledmat_refreshes(), (unsigned long) ((uint64_t) ledmat_interval_max() * 1000000 / TIMER_RATE));
+    hal_console_write(line);
+
+    for (row = 0; row < TINYGL_HEIGHT; row++) {
+        length = 0;
+        for (column = 0; column < TINYGL_WIDTH; column++) {
+            length += snprintf(line + length, sizeof(line) - length, " %5.1f",
+                ledmat_time() ? 100.0 * ledmat_lit_time(column, row) / ledmat_time() : 0.0);
+        }
+        snprintf(line + length, sizeof(line) - length, "\n");
+        hal_console_write(line);
+    }
+#endif
+#endif
 }
\ No newline at end of file
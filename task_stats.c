@@ -0,0 +1,117 @@
+/**
+    @file   task_stats.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Times every run of the scheduled tasks, to find the ones that hold up the others.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "task_stats.h"
+#include "timer.h"
+
+#define TASK_STATS_NAME_WIDTH 20
+
+
+/** Runs a task through its statistics, timing it and how late it started. */
+static void task_stats_run(void* data)
+{
+    task_stats_t* stats = (task_stats_t*) data;
+    scheduler_tick_t late = timer_get() - stats->task->deadline;
+    uint32_t elapsed;
+    uint32_t start;
+    int16_t lateness;
+    uint8_t bucket = 0;
+
+    if (late > (scheduler_tick_t) ~0 >> 1) {
+        late = -late;
+        lateness = late > INT16_MAX ? INT16_MIN : -(int16_t) late;
+    } else {
+        lateness = late > INT16_MAX ? INT16_MAX : (int16_t) late;
+    }
+
+    if (stats->runs == 0 || lateness < stats->late_min) {
+        stats->late_min = lateness;
+    }
+    if (stats->runs == 0 || lateness > stats->late_max) {
+        stats->late_max = lateness;
+    }
+
+    start = hal_cycles();
+    stats->func(stats->data);
+    elapsed = hal_cycles() - start;
+
+    stats->runs++;
+    stats->total += elapsed;
+    if (elapsed < stats->min) {
+        stats->min = elapsed;
+    }
+    if (elapsed > stats->max) {
+        stats->max = elapsed;
+    }
+    if (elapsed > stats->task->period * (HAL_CYCLE_RATE / SCHEDULER_RATE)) {
+        stats->overruns++;
+    }
+
+    for (; elapsed >= 4 && bucket < TASK_STATS_BUCKETS - 1; elapsed >>= 2)
+        bucket++;
+
+    if (stats->histogram[bucket] < UINT16_MAX) {
+        stats->histogram[bucket]++;
+    }
+}
+
+
+/** Starts the cycle counter and makes each task run through its statistics, which are cleared. */
+void task_stats_wrap(scheduler_task_t* tasks, task_stats_t* stats, uint8_t num_tasks)
+{
+    uint8_t i;
+
+    hal_cycles_init();
+
+    for (i = 0; i < num_tasks; i++) {
+        memset(&stats[i], 0, sizeof(stats[i]));
+        stats[i].task = &tasks[i];
+        stats[i].func = tasks[i].func;
+        stats[i].data = tasks[i].data;
+        stats[i].min = UINT32_MAX;
+
+        tasks[i].func = task_stats_run;
+        tasks[i].data = &stats[i];
+    }
+}
+
+
+/** Writes the statistics as a table, one line per task named by names, each line passed to write. */
+void task_stats_dump(task_stats_t* stats, const char* const* names, uint8_t num_tasks, task_stats_write_t write)
+{
+    char line[TASK_STATS_LINE_SIZE];
+    uint8_t length;
+    uint8_t i;
+    uint8_t j;
+
+    snprintf(line, sizeof(line), "%-*s %8s %8s %8s %8s %8s %6s %6s  histogram (4^i cycles)\n", TASK_STATS_NAME_WIDTH,
+        "task", "runs", "min", "mean", "max", "overrun", "late-", "late+");
+    write(line);
+
+    for (i = 0; i < num_tasks; i++) {
+        length = snprintf(line, sizeof(line), "%-*s %8lu %8lu %8lu %8lu %8lu %6d %6d ", TASK_STATS_NAME_WIDTH, names[i],
+            (unsigned long) stats[i].runs,
+            (unsigned long) (stats[i].runs ? stats[i].min : 0),
+            (unsigned long) (stats[i].runs ? stats[i].total / stats[i].runs : 0),
+            (unsigned long) stats[i].max,
+            (unsigned long) stats[i].overruns,
+            stats[i].late_min, stats[i].late_max);
+
+        for (j = 0; j < TASK_STATS_BUCKETS && length < sizeof(line); j++) {
+            length += snprintf(line + length, sizeof(line) - length, " %u", stats[i].histogram[j]);
+        }
+
+        if (length < sizeof(line) - 1) {
+            line[length++] = '\n';
+            line[length] = '\0';
+        }
+        write(line);
+    }
+}
@@ -0,0 +1,55 @@
+/**
+    @file   task_stats.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Times every run of the scheduled tasks, to find the ones that hold up the others.
+
+    Each task's function is swapped for one that reads the cycle counter around it, and keeps:
+     - the number of runs and the min, mean and max execution time,
+     - a histogram of execution times, bucket i counting the runs that took from 4^i up to 4^(i + 1)
+       cycles, with the first bucket also counting the shorter runs and the last bucket the longer,
+       each count stopping at 65535,
+     - the overruns, the runs that took longer than the task's period, so the next run was late,
+     - the lateness, the smallest and largest time from when a run was due to when it started, in
+       scheduler ticks.
+    Times are in cycles of the cycle counter (hal.h), so CPU cycles on the board and nanoseconds on
+    the host. The host scheduler's clock does not move while a task runs unless TETRIS_HOST_CPU_SCALE
+    is set (timer.h), so otherwise on the host every run starts on time.
+
+    The statistics take about 50 bytes of RAM per task, so they are only built in with TASK_STATS defined.
+*/
+
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include "system.h"
+#include "scheduler.h"
+
+#define TASK_STATS_BUCKETS 8
+#define TASK_STATS_LINE_SIZE 160
+
+/** The timing of one task, and the task with the function and data it was scheduled with. */
+typedef struct {
+    scheduler_task_t* task;
+    scheduler_func_t func;
+    void* data;
+    uint32_t runs;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t overruns;
+    int16_t late_min;
+    int16_t late_max;
+    uint16_t histogram[TASK_STATS_BUCKETS];
+} task_stats_t;
+
+/** Takes each line of the statistics table, for example to print it. */
+typedef void (*task_stats_write_t)(const char* line);
+
+/** Starts the cycle counter and makes each task run through its statistics, which are cleared. */
+void task_stats_wrap(scheduler_task_t* tasks, task_stats_t* stats, uint8_t num_tasks);
+
+/** Writes the statistics as a table, one line per task named by names, each line passed to write. */
+void task_stats_dump(task_stats_t* stats, const char* const* names, uint8_t num_tasks, task_stats_write_t write);
+
+#endif
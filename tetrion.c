@@ -19,89 +19,160 @@ tetrion_t tetrion_create(void)
 }
 
 
-/** Clears all pixels from the display. Needed for the game over. */
+/** Clears all pixels from the display and the lines scored. Needed to start a new game. */
 void tetrion_clear(tetrion_t* tetrion)
 {
     uint8_t i;
 
-    for (i = 0; i < ARRAY_SIZE(tetrion->display); i++)
-        tetrion->display[i] = PIXEL_OFF;
+    for (i = 0; i < ARRAY_SIZE(tetrion->rows); i++)
+        tetrion->rows[i] = 0;
+
+    for (i = 0; i < ARRAY_SIZE(tetrion->heights); i++)
+        tetrion->heights[i] = 0;
+
+    tetrion->lines = 0;
 }
 
 
-/**
-    Removes the full line and lets all pixels drop. This function is passed the index (height) of a line that is full and needs removing.
-    Full lines are determined in the tetrion_check_lines function which calls this function on all lines which are full.
- */
-static void tetrion_clear_line(tetrion_t* tetrion, uint8_t index)
+/** Returns PIXEL_ON if the pixel at (x, y) on the tetrion is filled, otherwise PIXEL_OFF. */
+uint8_t tetrion_get_pixel(tetrion_t* tetrion, uint8_t x, uint8_t y)
+{
+    return (tetrion->rows[y] >> x) & PIXEL_ON;
+}
+
+
+/** Adds a byte to an FNV-1a hash. */
+static uint32_t tetrion_hash_byte(uint32_t hash, uint8_t byte)
+{
+    return (hash ^ byte) * 16777619UL;
+}
+
+
+/** Returns a 32 bit FNV-1a hash of the locked pixels, the falling tetromino and the lines, to check two games ended the same. */
+uint32_t tetrion_hash(tetrion_t* tetrion)
 {
-    int8_t i;
-    int8_t j;
-    static uint8_t lines = 0;
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
 
-    for (i = index; i > 0; i--) {
-        for (j = 0; j < TINYGL_WIDTH; j++) {
-            tetrion->display[(i) * TINYGL_WIDTH + j] = tetrion->display[(i - 1) * TINYGL_WIDTH + j];
+    // rows are hashed as 2 bytes, the widest a row can be
+    for (i = 0; i < TETRION_HEIGHT; i++) {
+        hash = tetrion_hash_byte(hash, tetrion->rows[i]);
+        hash = tetrion_hash_byte(hash, tetrion->rows[i] >> 8);
+    }
+
+    hash = tetrion_hash_byte(hash, tetrion->current_tetromino.type);
+    hash = tetrion_hash_byte(hash, tetrion->current_tetromino.rotation);
+    hash = tetrion_hash_byte(hash, tetrion->current_tetromino.position.x);
+    hash = tetrion_hash_byte(hash, tetrion->current_tetromino.position.y);
+
+    return tetrion_hash_byte(hash, tetrion->lines);
+}
+
+
+/** Works out the height of every column again from the rows, needed once lines are removed. */
+static void tetrion_update_heights(tetrion_t* tetrion)
+{
+    tetrion_row_t found = 0;
+    uint8_t x;
+    uint8_t y;
+
+    for (x = 0; x < TETRION_WIDTH; x++)
+        tetrion->heights[x] = 0;
+
+    for (y = 0; y < TETRION_HEIGHT && found != TETRION_FULL_ROW; y++) {
+        for (x = 0; x < TETRION_WIDTH; x++) {
+            if ((tetrion->rows[y] & ~found) & BIT(x)) {
+                tetrion->heights[x] = TETRION_HEIGHT - y;
+            }
         }
+        found |= tetrion->rows[y];
     }
+}
+
 
-    // empty top line
-    for (j = 0; j < TINYGL_WIDTH; j++) {
-        tetrion->display[j] = PIXEL_OFF;
+/** Returns the rows of the tetrion that are full, as a mask of their positions, without removing them. */
+tetrion_line_mask_t tetrion_full_lines(tetrion_t* tetrion)
+{
+    tetrion_line_mask_t full_lines = 0;
+    uint8_t y;
+
+    for (y = 0; y < TETRION_HEIGHT; y++) {
+        if (tetrion->rows[y] == TETRION_FULL_ROW) {
+            full_lines |= (tetrion_line_mask_t) 1 << y;
+        }
     }
 
-    lines++;
-    tetrion->lines = lines;
+    return full_lines;
 }
 
 
-/** Check if the lines on the tetrion are full lines, then removes the full lines by calling tetrion_clear_line. */
-void tetrion_check_lines(tetrion_t* tetrion)
+/**
+    Finds the full lines on the tetrion and removes them all in one pass, letting the pixels above drop.
+    Rows are walked from the bottom up, and each row that is kept is copied once, straight to where it ends up.
+    Returns the rows that were full, as a mask of their positions before they were removed.
+*/
+tetrion_line_mask_t tetrion_check_lines(tetrion_t* tetrion)
 {
-    uint8_t i;
-    uint8_t j;
-    bool full_line;
-
-    for (i = 0; i < TINYGL_HEIGHT; i++) {
-        full_line = true;
-        for (j = 0; j < TINYGL_WIDTH; j++) {
-            if (tetrion->display[i * TINYGL_WIDTH + j] == PIXEL_OFF) {
-                full_line = false;
-                break;
-            }
+    tetrion_line_mask_t full_lines = 0;
+    int8_t from;
+    int8_t to = TETRION_HEIGHT - 1;
+
+    for (from = TETRION_HEIGHT - 1; from >= 0; from--) {
+        if (tetrion->rows[from] == TETRION_FULL_ROW) {
+            full_lines |= (tetrion_line_mask_t) 1 << from;
+            tetrion->lines++;
+            continue;
         }
 
-        if (full_line) {
-            tetrion_clear_line(tetrion, i);
+        if (to != from) {
+            tetrion->rows[to] = tetrion->rows[from];
         }
+        to--;
     }
+
+    // empty the top lines left behind
+    for (; to >= 0; to--) {
+        tetrion->rows[to] = 0;
+    }
+
+    if (full_lines) {
+        tetrion_update_heights(tetrion);
+    }
+
+    return full_lines;
 }
 
 
-/** Tries to add a new tetromino and displays it. */
-bool tetrion_try_add_tetromino(tetrion_t* tetrion)
+/**
+    Checks if a tetromino fits on the tetrion: its box must be inside the edges and each row mask
+    of its shape ANDed with the tetrion row it covers must be empty. Nothing is written to the tetrion.
+*/
+bool tetrion_fits_tetromino(tetrion_t* tetrion, tetromino_t* tetromino)
 {
-    bool can_place;
+    tetromino_shape_t shape;
 
-    tetromino_create_random(&tetrion->current_tetromino, tetrion->random_ticks);
-    can_place = tetrion_can_place_tetromino(tetrion);
-    tetrion_display_tetromino(tetrion);
+    tetromino_get_shape(tetromino, &shape);
 
-    return can_place;
+    return tetrion_fits_shape(tetrion, &shape, tetromino->position);
 }
 
 
-/** Checks if a tetromino can be placed. */
-bool tetrion_can_place_tetromino(tetrion_t* tetrion)
+/**
+    Checks if a shape fits on the tetrion with its tetromino's (0,0) pixel at position, as
+    tetrion_fits_tetromino does, for callers that keep the shapes of each rotation already worked out.
+*/
+bool tetrion_fits_shape(tetrion_t* tetrion, tetromino_shape_t* shape, tetromino_pos_t position)
 {
+    int8_t x = position.x + shape->left;
+    int8_t y = position.y + shape->top;
     uint8_t i;
-    int8_t x;
-    int8_t y;
 
-    for (i = 0; i < MAX_PIXELS; i++) {
-        tetromino_get_actual_position(&tetrion->current_tetromino, i, &x, &y);
+    if (x < 0 || x + shape->width > TETRION_WIDTH || y < 0 || y + shape->height > TETRION_HEIGHT) {
+        return false;
+    }
 
-        if (tetrion->display[x + y * TINYGL_WIDTH] == PIXEL_ON) {
+    for (i = 0; i < shape->height; i++) {
+        if (tetrion->rows[y + i] & (shape->rows[i] << x)) {
             return false;
         }
     }
@@ -110,189 +181,236 @@ bool tetrion_can_place_tetromino(tetrion_t* tetrion)
 }
 
 
-/** Makes the tetromino visible by putting the pixels on. */
-void tetrion_display_tetromino(tetrion_t* tetrion)
+/** Makes the moved or rotated tetromino the current one if it fits, otherwise leaves the current one as it is. */
+static bool tetrion_try_replace_tetromino(tetrion_t* tetrion, tetromino_t* tetromino)
+{
+    if (!tetrion_fits_tetromino(tetrion, tetromino)) {
+        return false;
+    }
+
+    tetrion->current_tetromino = *tetromino;
+
+    return true;
+}
+
+
+/** Tries to add a new tetromino, returns false if it overlaps the locked pixels. */
+bool tetrion_try_add_tetromino(tetrion_t* tetrion)
+{
+    tetromino_create_random(&tetrion->current_tetromino, &tetrion->randomizer);
+    tetrion->current_tetromino.position.x = TETRION_START_X;
+
+    return tetrion_can_place_tetromino(tetrion);
+}
+
+
+/** Checks if the current tetromino can be placed, inside the tetrion and clear of its pixels. */
+bool tetrion_can_place_tetromino(tetrion_t* tetrion)
+{
+    return tetrion_fits_tetromino(tetrion, &tetrion->current_tetromino);
+}
+
+
+/**
+    Locks the tetromino into the tetrion by putting its pixels on, once it can no longer move down.
+    The heights of the columns it covers are raised to its highest pixel in each column.
+*/
+void tetrion_lock_tetromino(tetrion_t* tetrion)
 {
+    tetromino_shape_t shape;
+    uint8_t column;
     uint8_t i;
     int8_t x;
     int8_t y;
 
+    tetromino_get_shape(&tetrion->current_tetromino, &shape);
+    x = tetrion->current_tetromino.position.x + shape.left;
+    y = tetrion->current_tetromino.position.y + shape.top;
 
-    for (i = 0; i < MAX_PIXELS; i++) {
-        tetromino_get_actual_position(&tetrion->current_tetromino, i, &x, &y);
+    for (i = 0; i < shape.height; i++) {
+        if (y + i < 0 || y + i >= TETRION_HEIGHT) {
+            continue;
+        }
+
+        tetrion->rows[y + i] |= shape.rows[i] << x;
 
-        if (x < TINYGL_WIDTH && y < TINYGL_HEIGHT) {
-            tetrion->display[x + y * TINYGL_WIDTH] = PIXEL_ON;
+        for (column = 0; column < shape.width; column++) {
+            if (shape.rows[i] & BIT(column) && TETRION_HEIGHT - (y + i) > tetrion->heights[x + column]) {
+                tetrion->heights[x + column] = TETRION_HEIGHT - (y + i);
+            }
         }
     }
-
 }
 
 
-/** Hides the tetromino by putting the pixels off. */
-void tetrion_hide_tetromino(tetrion_t* tetrion)
+/** Writes the locked pixels with the falling tetromino drawn over them into rows, which is what the display shows. */
+void tetrion_compose(tetrion_t* tetrion, tetrion_row_t* rows)
 {
+    tetromino_shape_t shape;
     uint8_t i;
     int8_t x;
     int8_t y;
 
-    for (i = 0; i < MAX_PIXELS; i++) {
-        tetromino_get_actual_position(&tetrion->current_tetromino, i, &x, &y);
+    for (i = 0; i < TETRION_HEIGHT; i++)
+        rows[i] = tetrion->rows[i];
 
-        if (x < TINYGL_WIDTH && y < TINYGL_HEIGHT) {
-            tetrion->display[x + y * TINYGL_WIDTH] = PIXEL_OFF;
+    tetromino_get_shape(&tetrion->current_tetromino, &shape);
+    x = tetrion->current_tetromino.position.x + shape.left;
+    y = tetrion->current_tetromino.position.y + shape.top;
+
+    for (i = 0; i < shape.height; i++) {
+        if (y + i >= 0 && y + i < TETRION_HEIGHT) {
+            rows[y + i] |= shape.rows[i] << x;
         }
     }
 }
 
 
-/**
- * Hides the tetromino, moves it down, checks for collision.
- * If it can't be displayed, moves it back up.
- * Finally displays the tetromino again.
- */
-bool tetrion_try_move_down(tetrion_t* tetrion)
+/** Writes the falling tetromino where it would land, the ghost piece, into rows, with nothing else. */
+void tetrion_compose_ghost(tetrion_t* tetrion, tetrion_row_t* rows)
 {
-    bool success = true;
+    tetromino_shape_t shape;
+    uint8_t i;
+    int8_t x;
+    int8_t y;
 
-    tetrion_hide_tetromino(tetrion);
-    tetromino_move_down(&tetrion->current_tetromino);
+    for (i = 0; i < TETRION_HEIGHT; i++)
+        rows[i] = 0;
 
-    if (tetrion_collide_edges(tetrion) || !tetrion_can_place_tetromino(tetrion)) {
-        success = false;
-    }
+    tetromino_get_shape(&tetrion->current_tetromino, &shape);
+    x = tetrion->current_tetromino.position.x + shape.left;
+    y = tetrion->current_tetromino.position.y + shape.top + tetrion_drop_distance(tetrion);
 
-    if (!success) {
-        tetromino_move_up(&tetrion->current_tetromino);
+    for (i = 0; i < shape.height; i++) {
+        if (y + i >= 0 && y + i < TETRION_HEIGHT) {
+            rows[y + i] = shape.rows[i] << x;
+        }
     }
-
-    tetrion_display_tetromino(tetrion);
-
-    return success;
 }
 
 
 /**
- * Hides the tetromino, moves it left, checks for collision.
- * If it can't be displayed, moves it back right.
- * Finally displays the tetromino again.
- */
-bool tetrion_try_move_left(tetrion_t* tetrion)
+    Returns how many rows the tetromino can fall before it lands. When the tetromino is above the skyline
+    this is found from the column heights in O(width), otherwise by stepping it down a row at a time.
+*/
+uint8_t tetrion_drop_distance(tetrion_t* tetrion)
 {
-    bool success = true;
+    tetromino_shape_t shape;
+    tetromino_t tetromino;
+    uint8_t distance = TETRION_HEIGHT;
+    uint8_t column;
+    int8_t surface;
+    int8_t bottom;
+    int8_t x;
+    int8_t y;
 
-    tetrion_hide_tetromino(tetrion);
-    tetromino_move_left(&tetrion->current_tetromino);
+    tetromino_get_shape(&tetrion->current_tetromino, &shape);
+    x = tetrion->current_tetromino.position.x + shape.left;
+    y = tetrion->current_tetromino.position.y + shape.top;
 
-    if (tetrion_collide_edges(tetrion) || !tetrion_can_place_tetromino(tetrion)) {
-        success = false;
-    }
+    for (column = 0; column < shape.width; column++) {
+        surface = TETRION_HEIGHT - tetrion->heights[x + column];
+        bottom = y + shape.bottoms[column];
 
-    if (!success) {
-        tetromino_move_right(&tetrion->current_tetromino);
-    }
+        if (bottom >= surface) {
+            // tucked under an overhang, the skyline does not say where it lands
+            tetromino = tetrion->current_tetromino;
+            tetromino_move_down(&tetromino);
+            for (distance = 0; tetrion_fits_tetromino(tetrion, &tetromino); distance++) {
+                tetromino_move_down(&tetromino);
+            }
 
-    tetrion_display_tetromino(tetrion);
+            return distance;
+        }
 
-    return success;
+        if (surface - 1 - bottom < distance) {
+            distance = surface - 1 - bottom;
+        }
+    }
+
+    return distance;
 }
 
 
-/**
- * Hides the tetromino, moves it right, checks for collision.
- * If it can't be displayed, moves it back left.
- * Finally displays the tetromino again.
- */
-bool tetrion_try_move_right(tetrion_t* tetrion)
+/** Moves the tetromino straight down to where it lands and returns how many rows it fell. */
+uint8_t tetrion_hard_drop(tetrion_t* tetrion)
 {
-    bool success = true;
+    uint8_t distance = tetrion_drop_distance(tetrion);
 
-    tetrion_hide_tetromino(tetrion);
-    tetromino_move_right(&tetrion->current_tetromino);
+    tetrion->current_tetromino.position.y += distance;
+
+    return distance;
+}
 
-    if (tetrion_collide_edges(tetrion) || !tetrion_can_place_tetromino(tetrion)) {
-        success = false;
-    }
-        
-    if (!success) {
-        tetromino_move_left(&tetrion->current_tetromino);
-    }
 
-    tetrion_display_tetromino(tetrion);
+/** Moves the tetromino down if it fits there, returns false if it is left where it was. */
+bool tetrion_try_move_down(tetrion_t* tetrion)
+{
+    tetromino_t tetromino = tetrion->current_tetromino;
 
-    return success;
+    tetromino_move_down(&tetromino);
+
+    return tetrion_try_replace_tetromino(tetrion, &tetromino);
 }
 
 
-/**
- * Hides the tetromino, rotates it clockwise, checks for collision.
- * If it can't be displayed, rotates it back counterclockwise.
- * Finally displays the tetromino again.
- */
-bool tetrion_try_rotate_clockwise(tetrion_t* tetrion)
+/** Moves the tetromino left if it fits there, returns false if it is left where it was. */
+bool tetrion_try_move_left(tetrion_t* tetrion)
 {
-    bool success = true;
+    tetromino_t tetromino = tetrion->current_tetromino;
 
-    tetrion_hide_tetromino(tetrion);
-    tetromino_rotate_clockwise(&tetrion->current_tetromino);
+    tetromino_move_left(&tetromino);
+
+    return tetrion_try_replace_tetromino(tetrion, &tetromino);
+}
 
-    if (tetrion_collide_edges(tetrion) || !tetrion_can_place_tetromino(tetrion)) {
-        success = false;
-    }
-        
-    if (!success) {
-        tetromino_rotate_counterclockwise(&tetrion->current_tetromino);
-    }
 
-    tetrion_display_tetromino(tetrion);
+/** Moves the tetromino right if it fits there, returns false if it is left where it was. */
+bool tetrion_try_move_right(tetrion_t* tetrion)
+{
+    tetromino_t tetromino = tetrion->current_tetromino;
 
-    return success;
+    tetromino_move_right(&tetromino);
+
+    return tetrion_try_replace_tetromino(tetrion, &tetromino);
 }
 
 
-/**
- * Hides the tetromino, rotates it counterclockwise, checks for collision.
- * If it can't be displayed, rotates it back clockwise.
- * Finally displays the tetromino again.
- */
-bool tetrion_try_rotate_counterclockwise(tetrion_t* tetrion)
+/** Rotates the tetromino clockwise if it fits that way, returns false if it is left as it was. */
+bool tetrion_try_rotate_clockwise(tetrion_t* tetrion)
 {
-    bool success = true;
+    tetromino_t tetromino = tetrion->current_tetromino;
 
-    tetrion_hide_tetromino(tetrion);
-    tetromino_rotate_counterclockwise(&tetrion->current_tetromino);
+    tetromino_rotate_clockwise(&tetromino);
 
-    if (tetrion_collide_edges(tetrion) || !tetrion_can_place_tetromino(tetrion)) {
-        success = false;
-    }
-        
-    if (!success) {
-        tetromino_rotate_clockwise(&tetrion->current_tetromino);
-    }
+    return tetrion_try_replace_tetromino(tetrion, &tetromino);
+}
 
-    tetrion_display_tetromino(tetrion);
 
-    return success;
+/** Rotates the tetromino counterclockwise if it fits that way, returns false if it is left as it was. */
+bool tetrion_try_rotate_counterclockwise(tetrion_t* tetrion)
+{
+    tetromino_t tetromino = tetrion->current_tetromino;
+
+    tetromino_rotate_counterclockwise(&tetromino);
+
+    return tetrion_try_replace_tetromino(tetrion, &tetromino);
 }
 
 
 /** 
     Checks if a tetromino is outside the LED display (and tetrion board), returns true if
-    the tetromino collides, otherwise returns false.
+    the tetromino collides, otherwise returns false. Only the box around the shape needs checking.
 */
 bool tetrion_collide_edges(tetrion_t* tetrion)
 {
-    uint8_t i;
+    tetromino_shape_t shape;
     int8_t x;
     int8_t y;
 
-    for (i = 0; i < MAX_PIXELS; i++) {
-        tetromino_get_actual_position(&tetrion->current_tetromino, i, &x, &y);
-
-        if (x < 0 || x >= TINYGL_WIDTH || y < 0 || y >= TINYGL_HEIGHT) {
-            return true;
-        }
-    }
+    tetromino_get_shape(&tetrion->current_tetromino, &shape);
+    x = tetrion->current_tetromino.position.x + shape.left;
+    y = tetrion->current_tetromino.position.y + shape.top;
 
-    return false;
+    return x < 0 || x + shape.width > TETRION_WIDTH || y < 0 || y + shape.height > TETRION_HEIGHT;
 }
\ No newline at end of file
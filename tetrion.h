@@ -11,79 +11,137 @@
 #include "tetromino.h"
 #include "tinygl.h"
 
+/**
+    The tetrion is the size of the LED matrix, but can be built larger for simulations on the host,
+    up to 16 pixels wide and 32 pixels high.
+*/
+#ifndef TETRION_WIDTH
+#define TETRION_WIDTH TINYGL_WIDTH
+#endif
+
+#ifndef TETRION_HEIGHT
+#define TETRION_HEIGHT TINYGL_HEIGHT
+#endif
+
+/** The x position new tetrominos appear at, the middle of the tetrion. */
+#define TETRION_START_X (TETRION_WIDTH / 2 - 1)
+
+/** The row bitmask with every pixel of a row on, used to find full lines with a single compare. */
+#define TETRION_FULL_ROW ((tetrion_row_t) ((1UL << TETRION_WIDTH) - 1))
+
+/** A single row of the tetrion stored as a bitmask, bit x is set when the pixel in column x is on. */
+#if TETRION_WIDTH <= 8
+typedef uint8_t tetrion_row_t;
+#elif TETRION_WIDTH <= 16
+typedef uint16_t tetrion_row_t;
+#else
+#error "TETRION_WIDTH must be at most 16"
+#endif
+
+/** A set of rows of the tetrion stored as a bitmask, bit y is set for row y. */
+#if TETRION_HEIGHT <= 8
+typedef uint8_t tetrion_line_mask_t;
+#elif TETRION_HEIGHT <= 16
+typedef uint16_t tetrion_line_mask_t;
+#elif TETRION_HEIGHT <= 32
+typedef uint32_t tetrion_line_mask_t;
+#else
+#error "TETRION_HEIGHT must be at most 32"
+#endif
+
 /**
     The type used to store a tetris games tetrion (board).
-     - The display array stores whether each pixel on the board is on (filled)
-     - The current tetromino which is active. This changes each time a tetromino reaches the bottom.
+     - The rows array stores whether each pixel on the board is on (filled), one bitmask per row.
+       Only tetrominos that have reached the bottom are locked into the rows.
+     - The heights array is the skyline, for each column the number of rows from the bottom up to and
+       including its highest locked pixel. It is kept up to date as tetrominos lock and lines clear.
+     - The current tetromino which is active, kept apart from the rows until it locks. This changes each time a tetromino reaches the bottom.
      - The lines cleared so far, used to score the game.
-     - random_ticks is used to create a new random tetromino.
+     - The randomizer picks the type of each new tetromino.
 */
 typedef struct {
-    uint8_t display[TINYGL_WIDTH * TINYGL_HEIGHT];
+    tetrion_row_t rows[TETRION_HEIGHT];
+    uint8_t heights[TETRION_WIDTH];
     tetromino_t current_tetromino;
     uint8_t lines;
-    uint16_t random_ticks;
+    randomizer_t randomizer;
 } tetrion_t;
 
 /** Creates and empty tetrion (a.k.a. playing field). */
 tetrion_t tetrion_create(void);
 
-/** Clears all pixels from the display. Needed for the game over. */
+/** Clears all pixels from the display and the lines scored. Needed to start a new game. */
 void tetrion_clear(tetrion_t* tetrion);
 
-/** Check if the lines on the tetrion are full lines, then removes the full lines by calling tetrion_clear_line. */
-void tetrion_check_lines(tetrion_t* tetrion);
+/** Returns PIXEL_ON if the pixel at (x, y) on the tetrion is filled, otherwise PIXEL_OFF. */
+uint8_t tetrion_get_pixel(tetrion_t* tetrion, uint8_t x, uint8_t y);
+
+/** Returns a 32 bit FNV-1a hash of the locked pixels, the falling tetromino and the lines, to check two games ended the same. */
+uint32_t tetrion_hash(tetrion_t* tetrion);
+
+/** Returns the rows of the tetrion that are full, as a mask of their positions, without removing them. */
+tetrion_line_mask_t tetrion_full_lines(tetrion_t* tetrion);
+
+/**
+    Finds the full lines on the tetrion and removes them all in one pass, letting the pixels above drop.
+    Returns the rows that were full, as a mask of their positions before they were removed.
+*/
+tetrion_line_mask_t tetrion_check_lines(tetrion_t* tetrion);
+
+/**
+    Checks if a tetromino fits on the tetrion: its box must be inside the edges and each row mask
+    of its shape ANDed with the tetrion row it covers must be empty. Nothing is written to the tetrion.
+*/
+bool tetrion_fits_tetromino(tetrion_t* tetrion, tetromino_t* tetromino);
+
+/**
+    Checks if a shape fits on the tetrion with its tetromino's (0,0) pixel at position, as
+    tetrion_fits_tetromino does, for callers that keep the shapes of each rotation already worked out.
+*/
+bool tetrion_fits_shape(tetrion_t* tetrion, tetromino_shape_t* shape, tetromino_pos_t position);
 
-/** Tries to add a new tetromino and displays it. */
+/** Tries to add a new tetromino, returns false if it overlaps the locked pixels. */
 bool tetrion_try_add_tetromino(tetrion_t* tetrion);
 
-/** Checks if a tetromino can be placed. */
+/** Checks if the current tetromino can be placed, inside the tetrion and clear of its pixels. */
 bool tetrion_can_place_tetromino(tetrion_t* tetrion);
 
-/** Makes the tetromino visible by putting the pixels on. */
-void tetrion_display_tetromino(tetrion_t* tetrion);
+/** Locks the tetromino into the tetrion by putting its pixels on, once it can no longer move down. */
+void tetrion_lock_tetromino(tetrion_t* tetrion);
 
-/** Hides the tetromino by putting the pixels off. */
-void tetrion_hide_tetromino(tetrion_t* tetrion);
+/** Writes the locked pixels with the falling tetromino drawn over them into rows, which is what the display shows. */
+void tetrion_compose(tetrion_t* tetrion, tetrion_row_t* rows);
+
+/** Writes the falling tetromino where it would land, the ghost piece, into rows, with nothing else. */
+void tetrion_compose_ghost(tetrion_t* tetrion, tetrion_row_t* rows);
 
 /**
- * Hides the tetromino, moves it down, checks for collision.
- * If it can't be displayed, moves it back up.
- * Finally displays the tetromino again.
- */
+    Returns how many rows the tetromino can fall before it lands. When the tetromino is above the skyline
+    this is found from the column heights in O(width), otherwise by stepping it down a row at a time.
+*/
+uint8_t tetrion_drop_distance(tetrion_t* tetrion);
+
+/** Moves the tetromino straight down to where it lands and returns how many rows it fell. */
+uint8_t tetrion_hard_drop(tetrion_t* tetrion);
+
+/** Moves the tetromino down if it fits there, returns false if it is left where it was. */
 bool tetrion_try_move_down(tetrion_t* tetrion);
 
-/**
- * Hides the tetromino, moves it left, checks for collision.
- * If it can't be displayed, moves it back right.
- * Finally displays the tetromino again.
- */
+/** Moves the tetromino left if it fits there, returns false if it is left where it was. */
 bool tetrion_try_move_left(tetrion_t* tetrion);
 
-/**
- * Hides the tetromino, moves it right, checks for collision.
- * If it can't be displayed, moves it back left.
- * Finally displays the tetromino again.
- */
+/** Moves the tetromino right if it fits there, returns false if it is left where it was. */
 bool tetrion_try_move_right(tetrion_t* tetrion);
 
-/**
- * Hides the tetromino, rotates it clockwise, checks for collision.
- * If it can't be displayed, rotates it back counterclockwise.
- * Finally displays the tetromino again.
- */
+/** Rotates the tetromino clockwise if it fits that way, returns false if it is left as it was. */
 bool tetrion_try_rotate_clockwise(tetrion_t* tetrion);
 
-/**
- * Hides the tetromino, rotates it counterclockwise, checks for collision.
- * If it can't be displayed, rotates it back clockwise.
- * Finally displays the tetromino again.
- */
+/** Rotates the tetromino counterclockwise if it fits that way, returns false if it is left as it was. */
 bool tetrion_try_rotate_counterclockwise(tetrion_t* tetrion);
 
 /** 
     Checks if a tetromino is outside the LED display (and tetrion board), returns true if
-    the tetromino collides, otherwise returns false.
+    the tetromino collides, otherwise returns false. Only the box around the shape needs checking.
 */
 bool tetrion_collide_edges(tetrion_t* tetrion);
 
@@ -14,11 +14,7 @@
 /** Main function where everything is set up for the tetris game. */
 int main(void)
 {
-    game_data_t game_data = 
-    {
-        .state = STATE_INIT,
-        .tetrion = tetrion_create()
-    };
+    game_data_t game_data = game_create(0, RANDOMIZER_MODE_BAG);
 
     task_manager_run(&game_data);
 
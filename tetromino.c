@@ -8,8 +8,88 @@
 #include "tetromino.h"
 #include "tinygl.h"
 #include <stdlib.h>
+#include <string.h>
 
-#define START_POSITION {1, 0}
+/** On the AVR the shape table is kept in flash and copied out when needed, saving RAM. */
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define TETROMINO_ROM PROGMEM
+#define tetromino_rom_copy(dest, src, size) memcpy_P(dest, src, size)
+#else
+#define TETROMINO_ROM
+#define tetromino_rom_copy(dest, src, size) memcpy(dest, src, size)
+#endif
+
+
+/**
+    The shape of every tetromino type in every rotation, indexed by tetromino_type_t and then rotation.
+    Rotation 0 is the shape a tetromino is created with, each next rotation is 90 degrees clockwise about the (0,0) pixel.
+    Pixel numbers below are the order of the pixels in rotation 0.
+
+    o tetromino     i tetromino     t tetromino
+    ------------    ------------    ------------
+    01              0123    0       0   1 012 0
+    23                      1       123 02  3  13
+                            2           3     2
+                            3
+
+    s tetramino     z tetramino     l tetramino             j tetramino
+    ------------    ------------    ------------            ------------
+     23 0           01   3               01       0             01      0
+    01  12           23 02            3   2  012  1         0   2  012  1
+         3              1           012   3  3    23        123 3    3 23
+*/
+static const tetromino_shape_t shapes[MAX_TETROMINO_TYPES][MAX_ROTATIONS] TETROMINO_ROM = {
+    /* O */
+    {
+        { .pixels = { {0, 0}, {0, 1}, {1, 0}, {1, 1} }, .left = 0, .top = 0, .width = 2, .height = 2, .rows = { 0x3, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } },
+        { .pixels = { {0, 0}, {1, 0}, {0, -1}, {1, -1} }, .left = 0, .top = -1, .width = 2, .height = 2, .rows = { 0x3, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } },
+        { .pixels = { {0, 0}, {0, -1}, {-1, 0}, {-1, -1} }, .left = -1, .top = -1, .width = 2, .height = 2, .rows = { 0x3, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } },
+        { .pixels = { {0, 0}, {-1, 0}, {0, 1}, {-1, 1} }, .left = -1, .top = 0, .width = 2, .height = 2, .rows = { 0x3, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } }
+    },
+    /* I */
+    {
+        { .pixels = { {-1, 0}, {0, 0}, {1, 0}, {2, 0} }, .left = -1, .top = 0, .width = 4, .height = 1, .rows = { 0xf, 0x0, 0x0, 0x0 }, .bottoms = { 0, 0, 0, 0 } },
+        { .pixels = { {0, 1}, {0, 0}, {0, -1}, {0, -2} }, .left = 0, .top = -2, .width = 1, .height = 4, .rows = { 0x1, 0x1, 0x1, 0x1 }, .bottoms = { 3, 0, 0, 0 } },
+        { .pixels = { {1, 0}, {0, 0}, {-1, 0}, {-2, 0} }, .left = -2, .top = 0, .width = 4, .height = 1, .rows = { 0xf, 0x0, 0x0, 0x0 }, .bottoms = { 0, 0, 0, 0 } },
+        { .pixels = { {0, -1}, {0, 0}, {0, 1}, {0, 2} }, .left = 0, .top = -1, .width = 1, .height = 4, .rows = { 0x1, 0x1, 0x1, 0x1 }, .bottoms = { 3, 0, 0, 0 } }
+    },
+    /* T */
+    {
+        { .pixels = { {-1, 0}, {0, 0}, {1, 0}, {0, 1} }, .left = -1, .top = 0, .width = 3, .height = 2, .rows = { 0x7, 0x2, 0x0, 0x0 }, .bottoms = { 0, 1, 0, 0 } },
+        { .pixels = { {0, 1}, {0, 0}, {0, -1}, {1, 0} }, .left = 0, .top = -1, .width = 2, .height = 3, .rows = { 0x1, 0x3, 0x1, 0x0 }, .bottoms = { 2, 1, 0, 0 } },
+        { .pixels = { {1, 0}, {0, 0}, {-1, 0}, {0, -1} }, .left = -1, .top = -1, .width = 3, .height = 2, .rows = { 0x2, 0x7, 0x0, 0x0 }, .bottoms = { 1, 1, 1, 0 } },
+        { .pixels = { {0, -1}, {0, 0}, {0, 1}, {-1, 0} }, .left = -1, .top = -1, .width = 2, .height = 3, .rows = { 0x2, 0x3, 0x2, 0x0 }, .bottoms = { 1, 2, 0, 0 } }
+    },
+    /* S */
+    {
+        { .pixels = { {-1, 1}, {0, 1}, {0, 0}, {1, 0} }, .left = -1, .top = 0, .width = 3, .height = 2, .rows = { 0x6, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } },
+        { .pixels = { {1, 1}, {1, 0}, {0, 0}, {0, -1} }, .left = 0, .top = -1, .width = 2, .height = 3, .rows = { 0x1, 0x3, 0x2, 0x0 }, .bottoms = { 1, 2, 0, 0 } },
+        { .pixels = { {1, -1}, {0, -1}, {0, 0}, {-1, 0} }, .left = -1, .top = -1, .width = 3, .height = 2, .rows = { 0x6, 0x3, 0x0, 0x0 }, .bottoms = { 1, 1, 0, 0 } },
+        { .pixels = { {-1, -1}, {-1, 0}, {0, 0}, {0, 1} }, .left = -1, .top = -1, .width = 2, .height = 3, .rows = { 0x1, 0x3, 0x2, 0x0 }, .bottoms = { 1, 2, 0, 0 } }
+    },
+    /* Z */
+    {
+        { .pixels = { {-1, 0}, {0, 0}, {0, 1}, {1, 1} }, .left = -1, .top = 0, .width = 3, .height = 2, .rows = { 0x3, 0x6, 0x0, 0x0 }, .bottoms = { 0, 1, 1, 0 } },
+        { .pixels = { {0, 1}, {0, 0}, {1, 0}, {1, -1} }, .left = 0, .top = -1, .width = 2, .height = 3, .rows = { 0x2, 0x3, 0x1, 0x0 }, .bottoms = { 2, 1, 0, 0 } },
+        { .pixels = { {1, 0}, {0, 0}, {0, -1}, {-1, -1} }, .left = -1, .top = -1, .width = 3, .height = 2, .rows = { 0x3, 0x6, 0x0, 0x0 }, .bottoms = { 0, 1, 1, 0 } },
+        { .pixels = { {0, -1}, {0, 0}, {-1, 0}, {-1, 1} }, .left = -1, .top = -1, .width = 2, .height = 3, .rows = { 0x2, 0x3, 0x1, 0x0 }, .bottoms = { 2, 1, 0, 0 } }
+    },
+    /* L */
+    {
+        { .pixels = { {-1, 0}, {-1, 1}, {0, 0}, {1, 0} }, .left = -1, .top = 0, .width = 3, .height = 2, .rows = { 0x7, 0x1, 0x0, 0x0 }, .bottoms = { 1, 0, 0, 0 } },
+        { .pixels = { {0, 1}, {1, 1}, {0, 0}, {0, -1} }, .left = 0, .top = -1, .width = 2, .height = 3, .rows = { 0x1, 0x1, 0x3, 0x0 }, .bottoms = { 2, 2, 0, 0 } },
+        { .pixels = { {1, 0}, {1, -1}, {0, 0}, {-1, 0} }, .left = -1, .top = -1, .width = 3, .height = 2, .rows = { 0x4, 0x7, 0x0, 0x0 }, .bottoms = { 1, 1, 1, 0 } },
+        { .pixels = { {0, -1}, {-1, -1}, {0, 0}, {0, 1} }, .left = -1, .top = -1, .width = 2, .height = 3, .rows = { 0x3, 0x2, 0x2, 0x0 }, .bottoms = { 0, 2, 0, 0 } }
+    },
+    /* J */
+    {
+        { .pixels = { {-1, 0}, {0, 0}, {1, 0}, {1, 1} }, .left = -1, .top = 0, .width = 3, .height = 2, .rows = { 0x7, 0x4, 0x0, 0x0 }, .bottoms = { 0, 0, 1, 0 } },
+        { .pixels = { {0, 1}, {0, 0}, {0, -1}, {1, -1} }, .left = 0, .top = -1, .width = 2, .height = 3, .rows = { 0x3, 0x1, 0x1, 0x0 }, .bottoms = { 2, 0, 0, 0 } },
+        { .pixels = { {1, 0}, {0, 0}, {-1, 0}, {-1, -1} }, .left = -1, .top = -1, .width = 3, .height = 2, .rows = { 0x1, 0x7, 0x0, 0x0 }, .bottoms = { 1, 1, 1, 0 } },
+        { .pixels = { {0, -1}, {0, 0}, {0, 1}, {-1, 1} }, .left = -1, .top = -1, .width = 2, .height = 3, .rows = { 0x2, 0x2, 0x3, 0x0 }, .bottoms = { 2, 2, 0, 0 } }
+    }
+};
 
 
 /** Takes a pointer to a tetromino tile and shifts the position up one tile. */
@@ -43,28 +123,21 @@ void tetromino_move_right(tetromino_t* tetromino)
 /** Takes a pointer to a tetromino tile and rotates the tile 90 degrees clockwise about the tiles (0,0) pixel. */
 void tetromino_rotate_clockwise(tetromino_t* tetromino) 
 {
-    int8_t x;
-
-    for (uint8_t i = 0; i < MAX_PIXELS; i++) {
-        
-        x = -1 * tetromino->pixels[i].x;
-        tetromino->pixels[i].x = tetromino->pixels[i].y;
-        tetromino->pixels[i].y = x;
-    }   
+    tetromino->rotation = (tetromino->rotation + 1) % MAX_ROTATIONS;
 }
 
 
 /** Takes a pointer to a tetromino tile and rotates the tile 90 degrees counterclockwise about the tiles (0,0) pixel. */
 void tetromino_rotate_counterclockwise(tetromino_t* tetromino) 
 {
-    int8_t y;
+    tetromino->rotation = (tetromino->rotation + MAX_ROTATIONS - 1) % MAX_ROTATIONS;
+}
+
 
-    for (uint8_t i = 0; i < MAX_PIXELS; i++) {
-        
-        y = -1 * tetromino->pixels[i].y;
-        tetromino->pixels[i].y = tetromino->pixels[i].x;
-        tetromino->pixels[i].x = y;
-    }      
+/** Copies the shape of the tetromino in its current rotation out of the shape table. */
+void tetromino_get_shape(tetromino_t* tetromino, tetromino_shape_t* shape)
+{
+    tetromino_rom_copy(shape, &shapes[tetromino->type][tetromino->rotation], sizeof(*shape));
 }
 
 
@@ -74,200 +147,27 @@ void tetromino_rotate_counterclockwise(tetromino_t* tetromino)
  */
 void tetromino_get_actual_position(tetromino_t* tetromino, uint8_t index, int8_t* x, int8_t* y)
 {
-    *x = tetromino->position.x + tetromino->pixels[index].x;
-    *y = tetromino->position.y + tetromino->pixels[index].y;
-}
+    pixel_t pixel;
 
+    tetromino_rom_copy(&pixel, &shapes[tetromino->type][tetromino->rotation].pixels[index], sizeof(pixel));
 
-/**
-    o tetromino
-    ------------
-    01
-    23
-*/
-static void tetromino_create_o(tetromino_t* tetromino)
-{
-    tetromino_t new_tetromino = {
-        .pixels={
-            {0, 0},
-            {0, 1},
-            {1, 0},
-            {1, 1}
-        }, 
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
+    *x = tetromino->position.x + pixel.x;
+    *y = tetromino->position.y + pixel.y;
 }
 
 
 /**
-    i tetromino
-    ------------
-    0123    0
-            1 
-            2
-            3
+    Asks the randomizer for a number in the range 0 - 6 and uses that number to create a new current tetromino. 
+    The random number determines which shape tetromino the new tetromino will be from the standard 7 tetris tiles.
+    The tetromino is created at (0,0), the tetrion moves it to where new tetrominos appear.
 */
-static void tetromino_create_i(tetromino_t* tetromino)
+void tetromino_create_random(tetromino_t* tetromino, randomizer_t* randomizer)
 {
     tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 0},
-            {0, 0},
-            {1, 0},
-            {2, 0}
-        }, 
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
-}
-
-
-/**
-    t tetromino
-    ------------
-    0   1 012 0 
-    123 02  3  13
-        3     2  
-*/
-static void tetromino_create_t(tetromino_t* tetromino) 
-{ 
-    tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 0},
-            {0, 0},
-            {1, 0},
-            {0, 1}
-        },  
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
-}
-
-
-/**
-    s tetramino 
-    ------------
-     23 0
-    01  12
-         3
-*/
-static void tetromino_create_s(tetromino_t* tetromino) 
-{ 
-    tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 1},
-            {0, 1},
-            {0, 0},
-            {1, 0}
-        }, 
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
-}
-
-
-/**
-    z tetramino
-    ------------
-    01   3
-     23 02
-        1
-*/
-static void tetromino_create_z(tetromino_t* tetromino) 
-{ 
-    tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 0},
-            {0, 0},
-            {0, 1},
-            {1, 1}
-        }, 
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
-}
-
-
-/**
-    l tetramino
-    ------------
-         01       0
-      3   2  012  1
-    012   3  3    23
-*/
-static void tetromino_create_l(tetromino_t* tetromino) 
-{ 
-    tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 0},
-            {-1, 1},
-            {0, 0},
-            {1, 0}
-        }, 
-        .position = START_POSITION
+        .type = randomizer_next(randomizer),
+        .rotation = 0,
+        .position = { 0, 0 }
     };
 
     *tetromino = new_tetromino;
 }
-
-
-/**
-    j tetramino
-    ------------
-        01      0
-    0   2  012  1
-    123 3    3 23
-*/
-static void tetromino_create_j(tetromino_t* tetromino) 
-{ 
-    tetromino_t new_tetromino = {
-        .pixels={
-            {-1, 0},
-            {0, 0},
-            {1, 0},
-            {1, 1}
-        }, 
-        .position = START_POSITION
-    };
-
-    *tetromino = new_tetromino;
-}
-
-
-/**
-    Chooses a random number in the range 0 - 6 and uses that number to create a new current tetromino. 
-    The random number determines which shape tetromino the new tetromino will be gfrom the standard 7 tetris tiles.
-*/
-void tetromino_create_random(tetromino_t* tetromino, uint16_t random_ticks)
-{
-    switch (random_ticks % MAX_TETROMINO_TYPES)
-    {
-        case TETROMINO_TYPE_O :
-            tetromino_create_o(tetromino);
-            break;
-        case TETROMINO_TYPE_I :
-             tetromino_create_i(tetromino);
-            break;
-        case TETROMINO_TYPE_T :
-            tetromino_create_t(tetromino);
-            break;
-        case TETROMINO_TYPE_S :
-            tetromino_create_s(tetromino);
-            break;
-        case TETROMINO_TYPE_Z :
-            tetromino_create_z(tetromino);
-            break;
-        case TETROMINO_TYPE_L :
-            tetromino_create_l(tetromino);
-            break;
-        case TETROMINO_TYPE_J :
-            tetromino_create_j(tetromino);
-            break;
-    }
-}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #ifndef H_TETROMINO
 #define H_TETROMINO
 
+#include "randomizer.h"
 #include "system.h"
 
 #define PIXEL_OFF 0
@@ -16,6 +17,8 @@
 
 #define MAX_TETROMINO_TYPES 7
 
+#define MAX_ROTATIONS 4
+
 /** Enum type containing all the posible tetromino tiles that can be created using the tetromino_create_random function. */
 typedef enum { 
     TETROMINO_TYPE_O,
@@ -40,21 +43,41 @@ typedef struct {
 } tetromino_pos_t;
 
 
+/**
+    The shape of one tetromino type in one rotation, precomputed in the shape table.
+     - the pixels relative to the center of the tile.
+     - left and top are the smallest pixel x and y, the corner of the box around the pixels.
+     - width and height are the size of the box around the pixels.
+     - rows are the pixels as one bitmask per row of the box, bit 0 being the left column.
+     - bottoms are the row of the box holding the lowest pixel of each column of the box, used to find where the tile lands.
+*/
+typedef struct {
+    pixel_t pixels[MAX_PIXELS];
+    int8_t left;
+    int8_t top;
+    uint8_t width;
+    uint8_t height;
+    uint8_t rows[MAX_PIXELS];
+    uint8_t bottoms[MAX_PIXELS];
+} tetromino_shape_t;
+
 /** 
     Tetromino type used for the tiles in a tetris game. This type is broken into:
-     - the pixels which determines the shape of the tile. 
+     - the type and rotation which select the shape of the tile from the shape table.
      - the position which determines when on the tetrion (board) the tile is
 */
 typedef struct {
-    pixel_t pixels[MAX_PIXELS];
+    uint8_t type;
+    uint8_t rotation;
     tetromino_pos_t position;
 } tetromino_t;
 
 /**
-    Chooses a random number in the range 0 - 6 and uses that number to create a new current tetromino. 
-    The random number determines which shape tetromino the new tetromino will be gfrom the standard 7 tetris tiles.
+    Asks the randomizer for a number in the range 0 - 6 and uses that number to create a new current tetromino. 
+    The random number determines which shape tetromino the new tetromino will be from the standard 7 tetris tiles.
+    The tetromino is created at (0,0), the tetrion moves it to where new tetrominos appear.
 */
-void tetromino_create_random(tetromino_t* tetromino, uint16_t random_ticks);
+void tetromino_create_random(tetromino_t* tetromino, randomizer_t* randomizer);
 
 /** Takes a pointer to a tetromino tile and shifts the position up one tile. */
 void tetromino_move_up(tetromino_t* tetromino);
@@ -74,6 +97,9 @@ void tetromino_rotate_clockwise(tetromino_t* tetromino);
 /** Takes a pointer to a tetromino tile and rotates the tile 90 degrees counterclockwise about the tiles (0,0) pixel. */
 void tetromino_rotate_counterclockwise(tetromino_t* tetromino);
 
+/** Copies the shape of the tetromino in its current rotation out of the shape table. */
+void tetromino_get_shape(tetromino_t* tetromino, tetromino_shape_t* shape);
+
 /**
     Takes a pointer to a tetromino tile, and index in the range 0 - MAX_PIXELS, a pointer to some x value and a pointer to some y value.
     The x and y values are set to the position of the pixel on the tetrion, by using the tetrominos position and the postion of the specific pixel.
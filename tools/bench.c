@@ -0,0 +1,389 @@
+/**
+    @file   bench.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Microbenchmarks of the tetrion and tetromino functions the game calls every step.
+
+    The benchmarks run over a set of board fixtures made by dropping tetrominos the way a game does:
+    each new tetromino is moved and turned a random amount, hard dropped and locked, and the tetrion
+    is kept just before its full lines are cleared, so the fixtures hold stacks with holes, wells and
+    lines ready to clear. Each benchmark calls its function across all the fixtures, over and over,
+    and reports the time and the heap allocations per call.
+
+    Functions that change the tetrion are given a copy of the fixture for each call, and the copy
+    is timed with them; the tetrion_copy benchmark is that copy alone, to take off their times.
+
+    The allocations are counted by wrapping malloc, calloc and realloc at link time.
+
+    Usage: bench [-j] [-l label] [-m milliseconds] [-f filter]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "game.h"
+#include "led_matrix.h"
+#include "ledmat.h"
+#include "tools.h"
+
+#define BENCH_FIXTURES 256
+#define BENCH_FIXTURE_SEED 1
+#define BENCH_BATCH 4096
+#define BENCH_MILLISECONDS_DEFAULT 200
+#define BENCH_MAX_MOVES 4
+
+/** A benchmark, which calls its function once on the fixture and returns something to keep the call from being optimised away. */
+typedef struct {
+    const char* name;
+    uint32_t (*run)(tetrion_t* fixture);
+} bench_t;
+
+/** The result of a benchmark. */
+typedef struct {
+    uint64_t ops;
+    double ns_per_op;
+    double allocs_per_op;
+} bench_result_t;
+
+static tetrion_t bench_fixtures[BENCH_FIXTURES];
+
+#if TETRION_WIDTH == TINYGL_WIDTH && TETRION_HEIGHT == TINYGL_HEIGHT
+static led_matrix_frame_t bench_frames[BENCH_FIXTURES];
+#endif
+
+/** The heap allocations made so far, counted by the wrapped allocation functions. */
+static volatile uint64_t bench_allocations;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+
+void* __wrap_malloc(size_t size)
+{
+    bench_allocations++;
+    return __real_malloc(size);
+}
+
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    bench_allocations++;
+    return __real_calloc(count, size);
+}
+
+
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    bench_allocations++;
+    return __real_realloc(pointer, size);
+}
+
+
+/** Drops tetrominos to fill the fixtures, starting the tetrion over whenever it tops out. */
+static void bench_make_fixtures(void)
+{
+    randomizer_t moves = randomizer_create(BENCH_FIXTURE_SEED, RANDOMIZER_MODE_RANDOM);
+    tetrion_t tetrion = tetrion_create();
+#if TETRION_WIDTH == TINYGL_WIDTH && TETRION_HEIGHT == TINYGL_HEIGHT
+    tetrion_row_t rows[TETRION_HEIGHT];
+#endif
+    uint16_t count = 0;
+    uint8_t turns;
+    uint8_t shift;
+    uint8_t i;
+
+    tetrion.randomizer = randomizer_create(BENCH_FIXTURE_SEED, RANDOMIZER_MODE_BAG);
+
+    while (count < BENCH_FIXTURES) {
+        if (!tetrion_try_add_tetromino(&tetrion)) {
+            tetrion_clear(&tetrion);
+            continue;
+        }
+
+        turns = randomizer_next(&moves) % MAX_ROTATIONS;
+        shift = randomizer_next(&moves) % BENCH_MAX_MOVES;
+
+        for (i = 0; i < turns; i++)
+            tetrion_try_rotate_clockwise(&tetrion);
+
+        for (i = 0; i < shift; i++) {
+            if (randomizer_next(&moves) % 2) {
+                tetrion_try_move_left(&tetrion);
+            } else {
+                tetrion_try_move_right(&tetrion);
+            }
+        }
+
+        tetrion_hard_drop(&tetrion);
+        tetrion_lock_tetromino(&tetrion);
+
+        // the next tetromino is where a new one appears, which is where the game tests most moves
+        bench_fixtures[count] = tetrion;
+        tetromino_create_random(&bench_fixtures[count].current_tetromino, &moves);
+        bench_fixtures[count].current_tetromino.position.x = TETRION_START_X;
+#if TETRION_WIDTH == TINYGL_WIDTH && TETRION_HEIGHT == TINYGL_HEIGHT
+        tetrion_compose_ghost(&bench_fixtures[count], rows);
+        led_matrix_frame_add(&bench_frames[count], rows, LED_MATRIX_LEVEL_DIM);
+        tetrion_compose(&bench_fixtures[count], rows);
+        led_matrix_frame_add(&bench_frames[count], rows, LED_MATRIX_LEVEL_MAX);
+#endif
+        count++;
+
+        tetrion_check_lines(&tetrion);
+    }
+}
+
+
+static uint32_t bench_copy(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    __asm__ volatile("" : : "r"(&tetrion) : "memory");
+
+    return tetrion.rows[TETRION_HEIGHT - 1];
+}
+
+
+static uint32_t bench_can_place(tetrion_t* fixture)
+{
+    return tetrion_can_place_tetromino(fixture);
+}
+
+
+static uint32_t bench_collide_edges(tetrion_t* fixture)
+{
+    return tetrion_collide_edges(fixture);
+}
+
+
+static uint32_t bench_check_lines(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_check_lines(&tetrion);
+}
+
+
+static uint32_t bench_try_move_down(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_try_move_down(&tetrion);
+}
+
+
+static uint32_t bench_try_move_left(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_try_move_left(&tetrion);
+}
+
+
+static uint32_t bench_try_move_right(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_try_move_right(&tetrion);
+}
+
+
+static uint32_t bench_try_rotate_clockwise(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_try_rotate_clockwise(&tetrion);
+}
+
+
+static uint32_t bench_try_rotate_counterclockwise(tetrion_t* fixture)
+{
+    tetrion_t tetrion = *fixture;
+
+    return tetrion_try_rotate_counterclockwise(&tetrion);
+}
+
+
+static uint32_t bench_create_random(tetrion_t* fixture)
+{
+    tetromino_t tetromino;
+
+    tetromino_create_random(&tetromino, &fixture->randomizer);
+
+    return tetromino.type;
+}
+
+
+#if TETRION_WIDTH == TINYGL_WIDTH && TETRION_HEIGHT == TINYGL_HEIGHT
+/** Returns the fixture's frame, its pixels at full brightness over the ghost piece dimmed, as the game shows it. */
+static led_matrix_frame_t* bench_frame(tetrion_t* fixture)
+{
+    return &bench_frames[fixture - bench_fixtures];
+}
+
+
+static uint32_t bench_led_matrix_draw(tetrion_t* fixture)
+{
+    led_matrix_draw(bench_frame(fixture));
+
+    return fixture->rows[0];
+}
+
+
+/** Draws the same frame every call, so no pixel changes and only the rows are compared. */
+static uint32_t bench_led_matrix_draw_unchanged(__unused__ tetrion_t* fixture)
+{
+    led_matrix_draw(&bench_frames[0]);
+
+    return bench_fixtures[0].rows[0];
+}
+
+
+/** Draws the fixture and shows every slot of every column of it once, into the LED matrix stand-in's framebuffer. */
+static uint32_t bench_led_matrix_frame(tetrion_t* fixture)
+{
+    uint8_t slots;
+
+    led_matrix_draw(bench_frame(fixture));
+    for (slots = 0; slots < TINYGL_WIDTH * LED_MATRIX_SLOTS; slots += led_matrix_update())
+        continue;
+
+    return ledmat_column_get(0);
+}
+#endif
+
+
+static const bench_t bench_benchmarks[] = {
+    { "tetrion_copy", bench_copy },
+    { "tetrion_can_place_tetromino", bench_can_place },
+    { "tetrion_collide_edges", bench_collide_edges },
+    { "tetrion_check_lines", bench_check_lines },
+    { "tetrion_try_move_down", bench_try_move_down },
+    { "tetrion_try_move_left", bench_try_move_left },
+    { "tetrion_try_move_right", bench_try_move_right },
+    { "tetrion_try_rotate_clockwise", bench_try_rotate_clockwise },
+    { "tetrion_try_rotate_counterclockwise", bench_try_rotate_counterclockwise },
+    { "tetromino_create_random", bench_create_random },
+#if TETRION_WIDTH == TINYGL_WIDTH && TETRION_HEIGHT == TINYGL_HEIGHT
+    { "led_matrix_draw", bench_led_matrix_draw },
+    { "led_matrix_draw_unchanged", bench_led_matrix_draw_unchanged },
+    { "led_matrix_frame", bench_led_matrix_frame },
+#endif
+};
+
+
+/** Runs a benchmark in batches over the fixtures until the time is up. */
+static bench_result_t bench_run(const bench_t* bench, uint32_t milliseconds)
+{
+    bench_result_t result = { 0 };
+    volatile uint32_t sink = 0;
+    uint64_t allocations;
+    uint64_t deadline;
+    uint64_t start;
+    uint32_t i;
+
+    // one batch to warm the caches and branch predictors
+    for (i = 0; i < BENCH_BATCH; i++)
+        sink += bench->run(&bench_fixtures[i % BENCH_FIXTURES]);
+
+    allocations = bench_allocations;
+    start = tools_nanoseconds();
+    deadline = start + milliseconds * 1000000ULL;
+
+    do {
+        for (i = 0; i < BENCH_BATCH; i++)
+            sink += bench->run(&bench_fixtures[i % BENCH_FIXTURES]);
+        result.ops += BENCH_BATCH;
+    } while (tools_nanoseconds() < deadline);
+
+    result.ns_per_op = (double) (tools_nanoseconds() - start) / result.ops;
+    result.allocs_per_op = (double) (bench_allocations - allocations) / result.ops;
+    (void) sink;
+
+    return result;
+}
+
+
+/** Prints text as a quoted JSON string, escaping quotes, backslashes and control characters. */
+static void bench_print_json_string(const char* text)
+{
+    putchar('"');
+    for (; *text != '\0'; text++) {
+        if (*text == '"' || *text == '\\') {
+            printf("\\%c", *text);
+        } else if ((unsigned char) *text < 0x20) {
+            printf("\\u%04x", (unsigned char) *text);
+        } else {
+            putchar(*text);
+        }
+    }
+    putchar('"');
+}
+
+
+int main(int argc, char** argv)
+{
+    bench_result_t results[ARRAY_SIZE(bench_benchmarks)];
+    uint32_t milliseconds = BENCH_MILLISECONDS_DEFAULT;
+    const char* filter = NULL;
+    const char* label = "";
+    bool json = false;
+    bool first = true;
+    uint8_t i;
+    int option;
+
+    while ((option = getopt(argc, argv, "jl:m:f:")) != -1) {
+        switch (option) {
+            case 'j':
+                json = true;
+                break;
+            case 'l':
+                label = optarg;
+                break;
+            case 'm':
+                milliseconds = strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: bench [-j] [-l label] [-m milliseconds] [-f filter]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    bench_make_fixtures();
+    led_matrix_init(1000);
+
+    for (i = 0; i < ARRAY_SIZE(bench_benchmarks); i++) {
+        if (filter == NULL || strstr(bench_benchmarks[i].name, filter)) {
+            results[i] = bench_run(&bench_benchmarks[i], milliseconds);
+        }
+    }
+
+    if (json) {
+        printf("{\n  \"label\": ");
+        bench_print_json_string(label);
+        printf(",\n  \"tetrion\": \"%ux%u\",\n  \"fixtures\": %u,\n  \"benchmarks\": [", TETRION_WIDTH, TETRION_HEIGHT, BENCH_FIXTURES);
+        for (i = 0; i < ARRAY_SIZE(bench_benchmarks); i++) {
+            if (filter == NULL || strstr(bench_benchmarks[i].name, filter)) {
+                printf("%s\n    { \"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f }", first ? "" : ",",
+                    bench_benchmarks[i].name, (unsigned long long) results[i].ops, results[i].ns_per_op, results[i].allocs_per_op);
+                first = false;
+            }
+        }
+        printf("\n  ]\n}\n");
+    } else {
+        printf("%-36s %12s %10s %10s\n", "benchmark", "ops", "ns/op", "allocs/op");
+        for (i = 0; i < ARRAY_SIZE(bench_benchmarks); i++) {
+            if (filter == NULL || strstr(bench_benchmarks[i].name, filter)) {
+                printf("%-36s %12llu %10.2f %10.3f\n", bench_benchmarks[i].name,
+                    (unsigned long long) results[i].ops, results[i].ns_per_op, results[i].allocs_per_op);
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
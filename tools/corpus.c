@@ -0,0 +1,368 @@
+/**
+    @file   corpus.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  An append only file holding many replays, read in place through mmap.
+*/
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "corpus.h"
+
+// the offsets in a mapped index are read as they are
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The corpus index is read in place, which needs a little endian host"
+#endif
+
+/** The index magic is padded to 8 bytes so the offsets after it are aligned in the mapped file. */
+#define CORPUS_INDEX_HEADER_SIZE 8
+#define CORPUS_SIZE_BYTES 4
+#define CORPUS_PATH_SIZE 4096
+
+
+/** Writes the name of the index file of the corpus at path into index_path. */
+static void corpus_index_path(const char* path, char* index_path)
+{
+    snprintf(index_path, CORPUS_PATH_SIZE, "%s%s", path, CORPUS_INDEX_SUFFIX);
+}
+
+
+/** Reads a 32 bit number, low byte first, from bytes that need not be aligned. */
+static uint32_t corpus_get_u32(const uint8_t* bytes)
+{
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+
+/** Writes a number of the given bytes, low byte first. */
+static bool corpus_put(FILE* file, uint64_t value, uint8_t bytes)
+{
+    uint8_t buffer[8];
+    uint8_t i;
+
+    for (i = 0; i < bytes; i++)
+        buffer[i] = value >> (8 * i);
+
+    return fwrite(buffer, 1, bytes, file) == bytes;
+}
+
+
+/**
+    Walks the replays of a data file open for appending, writing a new index of them, and cuts off
+    a replay left part written at the end. Returns the size of the data file, or 0 on failure.
+*/
+static uint64_t corpus_rebuild(FILE* data, const char* index_path)
+{
+    uint8_t size_bytes[CORPUS_SIZE_BYTES];
+    uint64_t offset = CORPUS_MAGIC_SIZE;
+    uint64_t end;
+    uint32_t size;
+    FILE* index;
+
+    fseek(data, 0, SEEK_END);
+    end = ftell(data);
+
+    index = fopen(index_path, "wb");
+    if (index == NULL) {
+        return 0;
+    }
+
+    fwrite(CORPUS_INDEX_MAGIC, 1, CORPUS_MAGIC_SIZE, index);
+    corpus_put(index, 0, CORPUS_INDEX_HEADER_SIZE - CORPUS_MAGIC_SIZE);
+
+    while (offset + CORPUS_SIZE_BYTES <= end) {
+        fseek(data, offset, SEEK_SET);
+        if (fread(size_bytes, 1, CORPUS_SIZE_BYTES, data) != CORPUS_SIZE_BYTES) {
+            break;
+        }
+        size = corpus_get_u32(size_bytes);
+        if (offset + CORPUS_SIZE_BYTES + size > end) {
+            break;
+        }
+        corpus_put(index, offset, 8);
+        offset += CORPUS_SIZE_BYTES + size;
+    }
+
+    fclose(index);
+
+    if (offset != end && ftruncate(fileno(data), offset) != 0) {
+        return 0;
+    }
+
+    return offset;
+}
+
+
+/**
+    Opens a corpus for appending, creating it if it does not exist. Returns false if it cannot be opened.
+    If the index does not end where the data file does, as after a crash between the two writes of
+    an append, the index is rebuilt from the data file first.
+*/
+bool corpus_writer_open(corpus_writer_t* writer, const char* path)
+{
+    char index_path[CORPUS_PATH_SIZE];
+    uint8_t magic[CORPUS_MAGIC_SIZE];
+    uint8_t size_bytes[CORPUS_SIZE_BYTES];
+    uint64_t last = 0;
+    long index_end;
+
+    corpus_index_path(path, index_path);
+
+    writer->failed = false;
+    writer->data = fopen(path, "ab+");
+    if (writer->data == NULL) {
+        return false;
+    }
+
+    fseek(writer->data, 0, SEEK_END);
+    writer->offset = ftell(writer->data);
+
+    if (writer->offset == 0) {
+        fwrite(CORPUS_MAGIC, 1, CORPUS_MAGIC_SIZE, writer->data);
+        writer->offset = CORPUS_MAGIC_SIZE;
+        remove(index_path);
+    } else {
+        fseek(writer->data, 0, SEEK_SET);
+        if (fread(magic, 1, CORPUS_MAGIC_SIZE, writer->data) != CORPUS_MAGIC_SIZE
+            || memcmp(magic, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0) {
+            fclose(writer->data);
+            return false;
+        }
+    }
+
+    writer->index = fopen(index_path, "ab+");
+    if (writer->index == NULL) {
+        fclose(writer->data);
+        return false;
+    }
+
+    fseek(writer->index, 0, SEEK_END);
+    index_end = ftell(writer->index);
+
+    if (index_end == 0) {
+        fwrite(CORPUS_INDEX_MAGIC, 1, CORPUS_MAGIC_SIZE, writer->index);
+        corpus_put(writer->index, 0, CORPUS_INDEX_HEADER_SIZE - CORPUS_MAGIC_SIZE);
+        index_end = CORPUS_INDEX_HEADER_SIZE;
+    } else if (index_end > CORPUS_INDEX_HEADER_SIZE && (index_end - CORPUS_INDEX_HEADER_SIZE) % 8 == 0) {
+        fseek(writer->index, index_end - 8, SEEK_SET);
+        if (fread(&last, 8, 1, writer->index) == 1) {
+            fseek(writer->data, last, SEEK_SET);
+            if (fread(size_bytes, 1, CORPUS_SIZE_BYTES, writer->data) == CORPUS_SIZE_BYTES) {
+                last += CORPUS_SIZE_BYTES + corpus_get_u32(size_bytes);
+            }
+        }
+    }
+
+    if (index_end == CORPUS_INDEX_HEADER_SIZE ? writer->offset != CORPUS_MAGIC_SIZE : last != writer->offset) {
+        fclose(writer->index);
+        writer->offset = corpus_rebuild(writer->data, index_path);
+        writer->index = fopen(index_path, "ab");
+        if (writer->offset == 0 || writer->index == NULL) {
+            fclose(writer->data);
+            return false;
+        }
+    }
+
+    // a stream that was read from must be positioned before it is written to
+    fseek(writer->data, 0, SEEK_END);
+    fseek(writer->index, 0, SEEK_END);
+
+    return true;
+}
+
+
+/**
+    Appends a replay of size bytes to the corpus. Returns false if it cannot be written, in which case
+    the data file is cut back to before the replay and the writer takes no more appends.
+*/
+bool corpus_append(corpus_writer_t* writer, const uint8_t* replay, uint32_t size)
+{
+    if (writer->failed) {
+        return false;
+    }
+
+    // the replay must be in the data file before the index points at it
+    if (corpus_put(writer->data, size, CORPUS_SIZE_BYTES) && fwrite(replay, 1, size, writer->data) == size
+        && fflush(writer->data) == 0 && corpus_put(writer->index, writer->offset, 8)) {
+        writer->offset += CORPUS_SIZE_BYTES + size;
+        return true;
+    }
+
+    // a part written index entry is caught when the corpus is next opened, and the index rebuilt
+    fflush(writer->data);
+    if (ftruncate(fileno(writer->data), writer->offset) == 0) {
+        fseek(writer->data, 0, SEEK_END);
+    }
+    writer->failed = true;
+
+    return false;
+}
+
+
+/** Closes a corpus open for appending. */
+void corpus_writer_close(corpus_writer_t* writer)
+{
+    fclose(writer->index);
+    fclose(writer->data);
+}
+
+
+/** Maps the whole of a file for reading, returns NULL if it cannot be mapped or is empty. */
+static void* corpus_map(const char* path, size_t* size)
+{
+    struct stat status;
+    void* map;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size = status.st_size;
+
+    return map;
+}
+
+
+/**
+    Returns true if the index matches the data file, its first replay straight after the magic and its
+    last replay ending the file. Appends write the replay before its offset, so checking the ends is enough.
+*/
+static bool corpus_index_valid(corpus_t* corpus)
+{
+    uint64_t last;
+
+    if (corpus->count == 0) {
+        return corpus->size == CORPUS_MAGIC_SIZE;
+    }
+
+    last = corpus->offsets[corpus->count - 1];
+    if (corpus->offsets[0] != CORPUS_MAGIC_SIZE || last + CORPUS_SIZE_BYTES > corpus->size) {
+        return false;
+    }
+
+    return last + CORPUS_SIZE_BYTES + corpus_get_u32(corpus->data + last) == corpus->size;
+}
+
+
+/** Finds the offsets of the replays by walking their sizes through the mapped data, stopping at one left part written. */
+static bool corpus_build_index(corpus_t* corpus)
+{
+    size_t capacity = 1024;
+    uint64_t offset = CORPUS_MAGIC_SIZE;
+    uint64_t* grown;
+    uint32_t size;
+
+    corpus->built = malloc(capacity * sizeof(uint64_t));
+    corpus->count = 0;
+
+    while (corpus->built && offset + CORPUS_SIZE_BYTES <= corpus->size) {
+        size = corpus_get_u32(corpus->data + offset);
+        if (offset + CORPUS_SIZE_BYTES + size > corpus->size) {
+            break;
+        }
+
+        if (corpus->count == capacity) {
+            capacity *= 2;
+            grown = realloc(corpus->built, capacity * sizeof(uint64_t));
+            if (grown == NULL) {
+                free(corpus->built);
+                corpus->built = NULL;
+                break;
+            }
+            corpus->built = grown;
+        }
+
+        corpus->built[corpus->count++] = offset;
+        offset += CORPUS_SIZE_BYTES + size;
+    }
+
+    corpus->offsets = corpus->built;
+
+    return corpus->built != NULL;
+}
+
+
+/**
+    Maps a corpus for reading. Returns false if it cannot be read or is not a corpus.
+    The index is used in place when it matches the data file, otherwise the offsets are found again.
+*/
+bool corpus_open(corpus_t* corpus, const char* path)
+{
+    char index_path[CORPUS_PATH_SIZE];
+
+    memset(corpus, 0, sizeof(*corpus));
+
+    corpus->data = corpus_map(path, &corpus->size);
+    if (corpus->data == NULL) {
+        return false;
+    }
+
+    if (corpus->size < CORPUS_MAGIC_SIZE || memcmp(corpus->data, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0) {
+        corpus_close(corpus);
+        return false;
+    }
+
+    corpus_index_path(path, index_path);
+    corpus->index_map = corpus_map(index_path, &corpus->index_size);
+
+    if (corpus->index_map && corpus->index_size >= CORPUS_INDEX_HEADER_SIZE
+        && memcmp(corpus->index_map, CORPUS_INDEX_MAGIC, CORPUS_MAGIC_SIZE) == 0
+        && (corpus->index_size - CORPUS_INDEX_HEADER_SIZE) % 8 == 0) {
+        corpus->offsets = (const uint64_t*) ((const uint8_t*) corpus->index_map + CORPUS_INDEX_HEADER_SIZE);
+        corpus->count = (corpus->index_size - CORPUS_INDEX_HEADER_SIZE) / 8;
+        if (corpus_index_valid(corpus)) {
+            return true;
+        }
+    }
+
+    if (!corpus_build_index(corpus)) {
+        corpus_close(corpus);
+        return false;
+    }
+
+    return true;
+}
+
+
+/** Returns the replay at index in place, and writes its size to size. */
+const uint8_t* corpus_get(corpus_t* corpus, size_t index, uint32_t* size)
+{
+    const uint8_t* entry = corpus->data + corpus->offsets[index];
+
+    *size = corpus_get_u32(entry);
+
+    return entry + CORPUS_SIZE_BYTES;
+}
+
+
+/** Unmaps a corpus. */
+void corpus_close(corpus_t* corpus)
+{
+    if (corpus->index_map) {
+        munmap(corpus->index_map, corpus->index_size);
+    }
+
+    if (corpus->data) {
+        munmap((void*) corpus->data, corpus->size);
+    }
+
+    free(corpus->built);
+    memset(corpus, 0, sizeof(*corpus));
+}
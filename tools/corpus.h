@@ -0,0 +1,80 @@
+/**
+    @file   corpus.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  An append only file holding many replays, read in place through mmap.
+
+    A corpus is two files:
+     - the data file, the magic "TRC1" and then each replay as its size (4 bytes) followed by its bytes,
+     - the index file, the data file's name with ".idx" added, the magic "TRI1" and then the offset
+       (8 bytes) of each replay in the data file.
+    Numbers are little endian. Both files are only ever appended to, the replay first and its offset
+    after, so a corpus cut short by a crash holds at most one replay the index does not know about.
+    When the index is missing or behind the data file, it is rebuilt in memory from the sizes.
+
+    Reading maps both files, and each replay is handed out as a pointer into the mapped data file,
+    so no replay is copied or parsed until it is played.
+*/
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define CORPUS_MAGIC "TRC1"
+#define CORPUS_INDEX_MAGIC "TRI1"
+#define CORPUS_MAGIC_SIZE 4
+#define CORPUS_INDEX_SUFFIX ".idx"
+
+/**
+    A corpus open for appending, the offset is where the next replay goes in the data file. Once an
+    append fails the writer is failed and refuses any more, so no index entry can point at the wrong replay.
+*/
+typedef struct {
+    FILE* data;
+    FILE* index;
+    uint64_t offset;
+    bool failed;
+} corpus_writer_t;
+
+/**
+    A corpus open for reading.
+     - The data is the mapped data file, size bytes long.
+     - The offsets are where each of the count replays starts, either in the mapped index file or,
+       when that had to be rebuilt, in memory of its own.
+*/
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    const uint64_t* offsets;
+    size_t count;
+    void* index_map;
+    size_t index_size;
+    uint64_t* built;
+} corpus_t;
+
+/** Opens a corpus for appending, creating it if it does not exist. Returns false if it cannot be opened. */
+bool corpus_writer_open(corpus_writer_t* writer, const char* path);
+
+/**
+    Appends a replay of size bytes to the corpus. Returns false if it cannot be written, in which case
+    the data file is cut back to before the replay and the writer takes no more appends.
+*/
+bool corpus_append(corpus_writer_t* writer, const uint8_t* replay, uint32_t size);
+
+/** Closes a corpus open for appending. */
+void corpus_writer_close(corpus_writer_t* writer);
+
+/** Maps a corpus for reading. Returns false if it cannot be read or is not a corpus. */
+bool corpus_open(corpus_t* corpus, const char* path);
+
+/** Returns the replay at index in place, and writes its size to size. */
+const uint8_t* corpus_get(corpus_t* corpus, size_t index, uint32_t* size);
+
+/** Unmaps a corpus. */
+void corpus_close(corpus_t* corpus);
+
+#endif
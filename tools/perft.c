@@ -0,0 +1,175 @@
+/**
+    @file   perft.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Counts every board reachable after a number of placements, like perft for chess move generators.
+
+    Starting from an empty tetrion, each tetromino of a fixed sequence is placed at every placement
+    the placement search finds, locked, and its full lines cleared, then the next tetromino is
+    placed on every resulting board. The count at each depth is the number of leaves of that tree,
+    so it changes if the collision, movement or line clearing code changes what is reachable, and
+    the time it takes measures the speed of those same paths.
+
+    The counts of the default sequence on the 5x7 tetrion are checked against known good values.
+
+    Usage: perft [-d depth] [-q sequence] [-r repeats]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "placement.h"
+#include "tools.h"
+
+#define PERFT_DEPTH_MAX 16
+#define PERFT_DEPTH_DEFAULT 8
+#define PERFT_SEQUENCE_DEFAULT "TILJOSZ"
+
+/** The letter of each tetromino type, in the order of tetromino_type_t. */
+static const char perft_letters[MAX_TETROMINO_TYPES] = { 'O', 'I', 'T', 'S', 'Z', 'L', 'J' };
+
+/** Known good counts of the default sequence on the 5x7 tetrion, by depth starting at 1. */
+#if TETRION_WIDTH == 5 && TETRION_HEIGHT == 7
+static const uint64_t perft_golden[] = { 14, 98, 1072, 6575, 9196, 17137, 28531, 91231, 117196, 249611 };
+#else
+static const uint64_t perft_golden[] = { 0 };
+#endif
+
+/** The tetromino types placed in turn, repeated when the depth is longer than the sequence, and a search for each depth. */
+typedef struct {
+    uint8_t types[PERFT_DEPTH_MAX];
+    uint8_t length;
+    placement_list_t lists[PERFT_DEPTH_MAX];
+} perft_t;
+
+
+/**
+    Returns the number of boards reached by placing depth more tetrominos on the tetrion, starting
+    with the tetromino at ply in the sequence. A tetromino that cannot appear ends that game, and
+    adds nothing. At the last ply the placements are counted without being made.
+*/
+static uint64_t perft_count(perft_t* perft, tetrion_t* tetrion, uint8_t ply, uint8_t depth)
+{
+    placement_list_t* list = &perft->lists[ply];
+    tetrion_t next;
+    uint64_t nodes = 0;
+    uint16_t count;
+    uint16_t i;
+
+    tetrion->current_tetromino.type = perft->types[ply % perft->length];
+    tetrion->current_tetromino.rotation = 0;
+    tetrion->current_tetromino.position.x = TETRION_START_X;
+    tetrion->current_tetromino.position.y = 0;
+
+    if (!tetrion_fits_tetromino(tetrion, &tetrion->current_tetromino)) {
+        return 0;
+    }
+
+    count = placement_generate(tetrion, list);
+    if (depth == 1) {
+        return count;
+    }
+
+    for (i = 0; i < count; i++) {
+        next = *tetrion;
+        next.current_tetromino = placement_get_tetromino(list, i);
+        tetrion_lock_tetromino(&next);
+        tetrion_check_lines(&next);
+        nodes += perft_count(perft, &next, ply + 1, depth - 1);
+    }
+
+    return nodes;
+}
+
+
+/** Reads a sequence of tetromino letters into the types, returns false if a letter is not a tetromino. */
+static bool perft_parse_sequence(perft_t* perft, const char* sequence)
+{
+    const char* letter;
+
+    perft->length = 0;
+
+    for (; *sequence && perft->length < PERFT_DEPTH_MAX; sequence++) {
+        letter = memchr(perft_letters, *sequence, sizeof(perft_letters));
+        if (letter == NULL) {
+            return false;
+        }
+        perft->types[perft->length++] = letter - perft_letters;
+    }
+
+    return perft->length > 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    static perft_t perft;
+    const char* sequence = PERFT_SEQUENCE_DEFAULT;
+    tetrion_t tetrion;
+    uint8_t depth = PERFT_DEPTH_DEFAULT;
+    uint16_t repeats = 1;
+    uint64_t nodes;
+    bool golden;
+    bool failed = false;
+    double seconds;
+    double start;
+    uint16_t r;
+    uint8_t d;
+    int option;
+
+    while ((option = getopt(argc, argv, "d:q:r:")) != -1) {
+        switch (option) {
+            case 'd':
+                depth = strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                sequence = optarg;
+                break;
+            case 'r':
+                repeats = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: perft [-d depth] [-q sequence] [-r repeats]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (depth < 1 || depth > PERFT_DEPTH_MAX || repeats < 1) {
+        fprintf(stderr, "perft: depth must be 1 to %u and repeats at least 1\n", PERFT_DEPTH_MAX);
+        return EXIT_FAILURE;
+    }
+
+    if (!perft_parse_sequence(&perft, sequence)) {
+        fprintf(stderr, "perft: sequence must be 1 to %u of the letters OITSZLJ\n", PERFT_DEPTH_MAX);
+        return EXIT_FAILURE;
+    }
+
+    golden = strcmp(sequence, PERFT_SEQUENCE_DEFAULT) == 0 && perft_golden[0] != 0;
+
+    printf("tetrion      %ux%u\n", TETRION_WIDTH, TETRION_HEIGHT);
+    printf("sequence     %s\n", sequence);
+    printf("depth            nodes    seconds        nodes/sec  check\n");
+
+    for (d = 1; d <= depth; d++) {
+        start = tools_seconds();
+        for (r = 0; r < repeats; r++) {
+            tetrion = tetrion_create();
+            nodes = perft_count(&perft, &tetrion, 0, d);
+        }
+        seconds = (tools_seconds() - start) / repeats;
+
+        printf("%5u  %15llu  %9.4f  %15.0f  ", d, (unsigned long long) nodes, seconds, seconds > 0 ? nodes / seconds : 0.0);
+
+        if (!golden || d > ARRAY_SIZE(perft_golden)) {
+            printf("-\n");
+        } else if (nodes == perft_golden[d - 1]) {
+            printf("ok\n");
+        } else {
+            printf("FAILED, expected %llu\n", (unsigned long long) perft_golden[d - 1]);
+            failed = true;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
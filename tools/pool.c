@@ -0,0 +1,165 @@
+/**
+    @file   pool.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  A work stealing thread pool for running many independent jobs on the host.
+*/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "pool.h"
+#include "tools.h"
+
+/** Packs a range of job indices into one word so it can be claimed with a single compare and swap. */
+#define POOL_RANGE(BEGIN, END) (((uint64_t) (END) << 32) | (BEGIN))
+#define POOL_RANGE_BEGIN(RANGE) ((uint32_t) (RANGE))
+#define POOL_RANGE_END(RANGE) ((uint32_t) ((RANGE) >> 32))
+
+/** The jobs left to a worker, padded to a cache line so workers do not share lines. */
+typedef struct {
+    _Alignas(TOOLS_CACHE_LINE) _Atomic uint64_t range;
+} pool_range_t;
+
+typedef struct pool_struct pool_t;
+
+typedef struct {
+    pool_t* pool;
+    uint16_t index;
+    pthread_t thread;
+    bool started;
+} pool_worker_t;
+
+struct pool_struct {
+    pool_range_t* ranges;
+    pool_worker_t* workers;
+    uint16_t count;
+    pool_job_t job;
+    void* context;
+};
+
+
+/** Takes the job at the front of a worker's own range, returns false once the range is empty. */
+static int pool_take(pool_range_t* own, uint32_t* index)
+{
+    uint64_t range = atomic_load(&own->range);
+    uint32_t begin;
+    uint32_t end;
+
+    do {
+        begin = POOL_RANGE_BEGIN(range);
+        end = POOL_RANGE_END(range);
+        if (begin >= end) {
+            return 0;
+        }
+    } while (!atomic_compare_exchange_weak(&own->range, &range, POOL_RANGE(begin + 1, end)));
+
+    *index = begin;
+    return 1;
+}
+
+
+/** Steals the back half of the fullest range of another worker into the worker's own range, returns false if there was nothing left. */
+static int pool_steal(pool_t* pool, uint16_t thief)
+{
+    uint64_t range;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t middle;
+    uint32_t most;
+    uint16_t victim;
+    uint16_t i;
+
+    for (;;) {
+        most = 0;
+        victim = thief;
+        for (i = 0; i < pool->count; i++) {
+            range = atomic_load(&pool->ranges[i].range);
+            begin = POOL_RANGE_BEGIN(range);
+            end = POOL_RANGE_END(range);
+            if (i != thief && end > begin && end - begin > most) {
+                most = end - begin;
+                victim = i;
+            }
+        }
+
+        if (victim == thief) {
+            return 0;
+        }
+
+        range = atomic_load(&pool->ranges[victim].range);
+        begin = POOL_RANGE_BEGIN(range);
+        end = POOL_RANGE_END(range);
+        if (begin >= end) {
+            continue;
+        }
+
+        middle = end - (end - begin + 1) / 2;
+        if (atomic_compare_exchange_strong(&pool->ranges[victim].range, &range, POOL_RANGE(begin, middle))) {
+            atomic_store(&pool->ranges[thief].range, POOL_RANGE(middle, end));
+            return 1;
+        }
+    }
+}
+
+
+/** Runs jobs from the worker's own range, stealing more until no worker has any left. */
+static void* pool_worker_run(void* data)
+{
+    pool_worker_t* worker = (pool_worker_t*) data;
+    pool_t* pool = worker->pool;
+    pool_range_t* own = &pool->ranges[worker->index];
+    uint32_t index;
+
+    do {
+        while (pool_take(own, &index)) {
+            pool->job(pool->context, index, worker->index);
+        }
+    } while (pool_steal(pool, worker->index));
+
+    return NULL;
+}
+
+
+/** Returns the number of processors online, used as the default number of workers. */
+uint16_t pool_default_workers(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (uint16_t) count : 1;
+}
+
+
+/** Runs count jobs on the given number of workers and returns when they are all done. */
+void pool_run(uint32_t count, uint16_t workers, pool_job_t job, void* context)
+{
+    pool_t pool = { .count = workers ? workers : 1, .job = job, .context = context };
+    uint16_t i;
+
+    pool.ranges = aligned_alloc(TOOLS_CACHE_LINE, sizeof(pool_range_t) * pool.count);
+    pool.workers = calloc(pool.count, sizeof(pool_worker_t));
+
+    for (i = 0; i < pool.count; i++) {
+        atomic_init(&pool.ranges[i].range, POOL_RANGE((uint64_t) count * i / pool.count, (uint64_t) count * (i + 1) / pool.count));
+        pool.workers[i].pool = &pool;
+        pool.workers[i].index = i;
+    }
+
+    // a worker whose thread could not be created leaves its range to be stolen by the calling thread
+    for (i = 1; i < pool.count; i++) {
+        pool.workers[i].started = pthread_create(&pool.workers[i].thread, NULL, pool_worker_run, &pool.workers[i]) == 0;
+    }
+
+    pool_worker_run(&pool.workers[0]);
+
+    for (i = 1; i < pool.count; i++) {
+        if (pool.workers[i].started) {
+            pthread_join(pool.workers[i].thread, NULL);
+        }
+    }
+
+    free(pool.workers);
+    free(pool.ranges);
+}
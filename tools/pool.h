@@ -0,0 +1,26 @@
+/**
+    @file   pool.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  A work stealing thread pool for running many independent jobs on the host.
+
+    The jobs are numbered 0 to count - 1 and split into one range per worker.
+    A worker takes jobs from the front of its own range and, once that is
+    empty, steals the back half of the fullest range of another worker.
+*/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdint.h>
+
+/** A job run by the pool, given the job index and the index of the worker running it. */
+typedef void (*pool_job_t)(void* context, uint32_t index, uint16_t worker);
+
+/** Returns the number of processors online, used as the default number of workers. */
+uint16_t pool_default_workers(void);
+
+/** Runs count jobs on the given number of workers and returns when they are all done. */
+void pool_run(uint32_t count, uint16_t workers, pool_job_t job, void* context);
+
+#endif
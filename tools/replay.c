@@ -0,0 +1,116 @@
+/**
+    @file   replay.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Plays recorded games back through the game with no pacing, and checks each ends as recorded.
+
+    Every replay is played from its seed and inputs, and the tetrion it ends with is checked against
+    the hash in the replay. The time taken is compared with the time the game took in real time, at
+    GAME_TICK_RATE steps per second.
+
+    Usage: replay [-r repeats] [-q] file...
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "game.h"
+#include "tools.h"
+
+/** Reads a whole file into memory, returns NULL if it cannot be read. The size is written to size. */
+static uint8_t* replay_load(const char* path, size_t* size)
+{
+    uint8_t* data;
+    FILE* file;
+    long length;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    data = malloc(length > 0 ? length : 1);
+    if (data && fread(data, 1, length, file) != (size_t) length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = length;
+
+    return data;
+}
+
+
+int main(int argc, char** argv)
+{
+    replay_status_t status = REPLAY_OK;
+    uint64_t total_steps = 0;
+    uint32_t failed = 0;
+    uint32_t steps = 0;
+    uint16_t repeats = 1;
+    bool quiet = false;
+    double seconds = 0;
+    double start;
+    uint8_t* data;
+    size_t size;
+    uint16_t r;
+    int option;
+    int i;
+
+    while ((option = getopt(argc, argv, "r:q")) != -1) {
+        switch (option) {
+            case 'r':
+                repeats = strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                fprintf(stderr, "usage: replay [-r repeats] [-q] file...\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc || repeats < 1) {
+        fprintf(stderr, "usage: replay [-r repeats] [-q] file...\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = optind; i < argc; i++) {
+        data = replay_load(argv[i], &size);
+        if (data == NULL) {
+            perror(argv[i]);
+            failed++;
+            continue;
+        }
+
+        start = tools_seconds();
+        for (r = 0; r < repeats; r++) {
+            status = replay_play(data, size, &steps);
+        }
+        seconds += tools_seconds() - start;
+        free(data);
+
+        total_steps += (uint64_t) steps * repeats;
+        if (status != REPLAY_OK) {
+            failed++;
+        }
+
+        if (!quiet || status != REPLAY_OK) {
+            printf("%s  %u steps  %s\n", argv[i], steps, tools_replay_status_name(status));
+        }
+    }
+
+    printf("replays      %d\n", argc - optind);
+    printf("failed       %u\n", failed);
+    printf("seconds      %.3f\n", seconds);
+    printf("steps/sec    %.0f\n", seconds > 0 ? total_steps / seconds : 0.0);
+    printf("real time    %.0fx\n", seconds > 0 ? total_steps / (double) GAME_TICK_RATE / seconds : 0.0);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+/**
+    @file   resim.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Plays every replay of a corpus back through the game in parallel, and reports any that end differently.
+
+    The corpus is mapped once and its replays are played in place, shared out over all processors
+    with the work stealing pool. Each replay's final tetrion is checked against its recorded hash,
+    and the replays that fail are listed by their index in the corpus.
+
+    With -a the replay files given are appended to the corpus instead, creating it if needed.
+
+    Usage: resim [-t threads] [-q] corpus
+           resim -a corpus replay...
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "corpus.h"
+#include "game.h"
+#include "pool.h"
+#include "tools.h"
+
+#define RESIM_FILE_MAX (1 << 24)
+
+/** The totals of the replays played by one worker, padded so workers do not share cache lines. */
+typedef struct {
+    _Alignas(TOOLS_CACHE_LINE) uint64_t replays;
+    uint64_t steps;
+    uint64_t failed;
+} resim_totals_t;
+
+typedef struct {
+    corpus_t corpus;
+    uint8_t* statuses;
+    resim_totals_t* totals;
+} resim_t;
+
+
+/** Plays one replay of the corpus and keeps its status. */
+static void resim_replay(void* context, uint32_t index, uint16_t worker)
+{
+    resim_t* resim = (resim_t*) context;
+    resim_totals_t* totals = &resim->totals[worker];
+    const uint8_t* replay;
+    uint32_t steps = 0;
+    uint32_t size;
+
+    replay = corpus_get(&resim->corpus, index, &size);
+    resim->statuses[index] = replay_play(replay, size, &steps);
+
+    totals->replays++;
+    totals->steps += steps;
+    totals->failed += resim->statuses[index] != REPLAY_OK;
+}
+
+
+/** Appends each replay file to the corpus, stopping at the first append that fails. Returns the number that could not be added. */
+static int resim_append(const char* path, char** files, int count)
+{
+    static uint8_t replay[RESIM_FILE_MAX];
+    corpus_writer_t writer;
+    size_t size;
+    FILE* file;
+    int failed = 0;
+    int i;
+
+    if (!corpus_writer_open(&writer, path)) {
+        fprintf(stderr, "resim: cannot open corpus %s\n", path);
+        return count;
+    }
+
+    for (i = 0; i < count; i++) {
+        file = fopen(files[i], "rb");
+        if (file == NULL) {
+            perror(files[i]);
+            failed++;
+            continue;
+        }
+
+        size = fread(replay, 1, sizeof(replay), file);
+        fclose(file);
+
+        if (size == sizeof(replay)) {
+            fprintf(stderr, "resim: %s is too large\n", files[i]);
+            failed++;
+        } else if (!corpus_append(&writer, replay, size)) {
+            fprintf(stderr, "resim: cannot add %s, stopping\n", files[i]);
+            failed += count - i;
+            break;
+        }
+    }
+
+    corpus_writer_close(&writer);
+
+    return failed;
+}
+
+
+int main(int argc, char** argv)
+{
+    resim_t resim;
+    resim_totals_t sum = { 0 };
+    uint16_t threads = pool_default_workers();
+    bool append = false;
+    bool quiet = false;
+    double seconds;
+    size_t i;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:qa")) != -1) {
+        switch (option) {
+            case 't':
+                threads = strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            case 'a':
+                append = true;
+                break;
+            default:
+                fprintf(stderr, "usage: resim [-t threads] [-q] corpus\n       resim -a corpus replay...\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc) {
+        fprintf(stderr, "usage: resim [-t threads] [-q] corpus\n       resim -a corpus replay...\n");
+        return EXIT_FAILURE;
+    }
+
+    if (append) {
+        return resim_append(argv[optind], argv + optind + 1, argc - optind - 1) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (!corpus_open(&resim.corpus, argv[optind])) {
+        fprintf(stderr, "resim: cannot read corpus %s\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    threads = threads ? threads : 1;
+    resim.statuses = malloc(resim.corpus.count ? resim.corpus.count : 1);
+    resim.totals = aligned_alloc(_Alignof(resim_totals_t), sizeof(resim_totals_t) * threads);
+    memset(resim.totals, 0, sizeof(resim_totals_t) * threads);
+
+    seconds = tools_seconds();
+    pool_run(resim.corpus.count, threads, resim_replay, &resim);
+    seconds = tools_seconds() - seconds;
+
+    for (i = 0; i < threads; i++) {
+        sum.replays += resim.totals[i].replays;
+        sum.steps += resim.totals[i].steps;
+        sum.failed += resim.totals[i].failed;
+    }
+
+    for (i = 0; i < resim.corpus.count; i++) {
+        if (resim.statuses[i] != REPLAY_OK || !quiet) {
+            printf("%zu  %s\n", i, tools_replay_status_name(resim.statuses[i]));
+        }
+    }
+
+    printf("replays      %llu\n", (unsigned long long) sum.replays);
+    printf("failed       %llu\n", (unsigned long long) sum.failed);
+    printf("threads      %u\n", threads);
+    printf("seconds      %.3f\n", seconds);
+    printf("replays/sec  %.0f\n", seconds > 0 ? sum.replays / seconds : 0.0);
+    printf("steps/sec    %.0f\n", seconds > 0 ? sum.steps / seconds : 0.0);
+
+    free(resim.totals);
+    free(resim.statuses);
+    corpus_close(&resim.corpus);
+
+    return sum.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
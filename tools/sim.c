@@ -0,0 +1,400 @@
+/**
+    @file   sim.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Headless batch simulator, plays many games to completion as fast as the host allows.
+
+    Each game is seeded with the base seed plus its number, and steps the game
+    directly with game_step rather than through the task scheduler. Games are
+    spread over all processors with the work stealing pool. With -w each game
+    is recorded as a replay, named by its number, in the given directory, and
+    with -c each game's replay is appended to the given corpus; both can be given.
+
+    Usage: sim [-g games] [-s seed] [-t threads] [-p idle|random|placement] [-r random|bag|history] [-m max_steps] [-w directory] [-c corpus]
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "corpus.h"
+#include "game.h"
+#include "placement.h"
+#include "pool.h"
+#include "tools.h"
+
+#define SIM_GAMES_DEFAULT 100000
+#define SIM_MAX_STEPS_DEFAULT 1000000
+#define SIM_LINES_MAX 256
+#define SIM_RANDOM_PRESS_CHANCE 3
+#define SIM_RANDOM_INPUTS 5
+#define SIM_PATH_SIZE 4096
+
+#define SIM_SCORE_LINE 76
+#define SIM_SCORE_HEIGHT 51
+#define SIM_SCORE_HOLE 36
+#define SIM_SCORE_BUMP 18
+
+/**
+    What a policy remembers between the steps of one game.
+     - The random state is an xorshift sequence for the policy's choices.
+     - The path is the inputs planned for the falling tetromino, and next is the input to push next.
+     - The list is the placement search of the falling tetromino.
+*/
+typedef struct {
+    uint32_t random_state;
+    game_input_t path[PLACEMENT_STATES + 1];
+    uint16_t length;
+    uint16_t next;
+    placement_list_t list;
+} sim_player_t;
+
+/** Chooses the buttons pushed for the next step of a game. */
+typedef game_input_t (*sim_policy_t)(sim_player_t* player, game_data_t* game_data);
+
+/** The totals of the games played by one worker, padded so workers do not share cache lines. */
+typedef struct {
+    _Alignas(TOOLS_CACHE_LINE) uint64_t games;
+    uint64_t pieces;
+    uint64_t steps;
+    uint64_t lines[SIM_LINES_MAX];
+} sim_totals_t;
+
+typedef struct {
+    uint32_t seed;
+    uint32_t max_steps;
+    sim_policy_t policy;
+    randomizer_mode_t mode;
+    const char* directory;
+    corpus_writer_t* corpus;
+    pthread_mutex_t corpus_lock;
+    sim_totals_t* totals;
+} sim_t;
+
+
+/** Mixes the base seed with the game number, so neighbouring games get unrelated input sequences. */
+static uint32_t sim_mix(uint32_t seed, uint32_t index)
+{
+    uint32_t x = seed + index * 0x9e3779b9;
+
+    x ^= x >> 16;
+    x *= 0x85ebca6b;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35;
+    x ^= x >> 16;
+
+    return x ? x : 1;
+}
+
+
+/** Steps the xorshift sequence of a game's policy. */
+static uint32_t sim_random(uint32_t* random_state)
+{
+    *random_state ^= *random_state << 13;
+    *random_state ^= *random_state >> 17;
+    *random_state ^= *random_state << 5;
+
+    return *random_state;
+}
+
+
+/** Never pushes a button, the tetrominos stack up where they appear. */
+static game_input_t sim_policy_idle(__unused__ sim_player_t* player, __unused__ game_data_t* game_data)
+{
+    return GAME_INPUT_NONE;
+}
+
+
+/** Now and then pushes one button picked at random. */
+static game_input_t sim_policy_random(sim_player_t* player, __unused__ game_data_t* game_data)
+{
+    uint32_t roll = sim_random(&player->random_state);
+
+    if (roll % SIM_RANDOM_PRESS_CHANCE) {
+        return GAME_INPUT_NONE;
+    }
+
+    return BIT((roll >> 8) % SIM_RANDOM_INPUTS);
+}
+
+
+/**
+    Scores the tetrion left by locking a tetromino at a placement: lines made are good, while the
+    total height, holes and the height differences between neighbouring columns are bad.
+*/
+static int32_t sim_score_placement(tetrion_t* tetrion, tetromino_t* tetromino)
+{
+    tetrion_t after = *tetrion;
+    int32_t score;
+    uint8_t x;
+    uint8_t y;
+
+    after.current_tetromino = *tetromino;
+    tetrion_lock_tetromino(&after);
+    score = SIM_SCORE_LINE * __builtin_popcount(tetrion_check_lines(&after));
+
+    // every empty pixel under the top of its column is a hole
+    for (x = 0; x < TETRION_WIDTH; x++) {
+        score -= SIM_SCORE_HEIGHT * after.heights[x];
+        if (x > 0) {
+            score -= SIM_SCORE_BUMP * abs(after.heights[x] - after.heights[x - 1]);
+        }
+        for (y = TETRION_HEIGHT - after.heights[x]; y < TETRION_HEIGHT; y++) {
+            if (!(after.rows[y] & BIT(x))) {
+                score -= SIM_SCORE_HOLE;
+            }
+        }
+    }
+
+    return score;
+}
+
+
+/**
+    Plans the best placement of each new tetromino with the placement search, then pushes the
+    buttons of its path one step at a time and finishes with a hard drop.
+*/
+static game_input_t sim_policy_placement(sim_player_t* player, game_data_t* game_data)
+{
+    tetromino_t tetromino;
+    int32_t best_score = INT32_MIN;
+    int32_t score;
+    uint16_t best = 0;
+    uint16_t count;
+    uint16_t i;
+
+    if (player->next < player->length) {
+        return player->path[player->next++];
+    }
+
+    count = placement_generate(&game_data->tetrion, &player->list);
+    if (count == 0) {
+        return GAME_INPUT_NONE;
+    }
+
+    for (i = 0; i < count; i++) {
+        tetromino = placement_get_tetromino(&player->list, i);
+        score = sim_score_placement(&game_data->tetrion, &tetromino);
+        if (score > best_score) {
+            best_score = score;
+            best = i;
+        }
+    }
+
+    player->length = placement_get_path(&player->list, best, player->path, PLACEMENT_STATES);
+    player->path[player->length++] = GAME_INPUT_HARD_DROP;
+    player->next = 0;
+
+    return player->path[player->next++];
+}
+
+
+/** Writes the bytes of a replay to the file given as the context. */
+static void sim_write_replay(void* context, const uint8_t* bytes, uint16_t size)
+{
+    fwrite(bytes, 1, size, (FILE*) context);
+}
+
+
+/** Plays one game to completion, or to the step limit, and adds it to the worker's totals. */
+static void sim_game(void* context, uint32_t index, uint16_t worker)
+{
+    sim_t* sim = (sim_t*) context;
+    sim_totals_t* totals = &sim->totals[worker];
+    game_data_t game_data = game_create(sim->seed + index, sim->mode);
+    replay_recorder_t recorder;
+    sim_player_t player;
+    char path[SIM_PATH_SIZE];
+    FILE* file = NULL;
+    char* replay = NULL;
+    size_t replay_size = 0;
+    game_input_t input;
+    uint32_t steps;
+
+    player.random_state = sim_mix(sim->seed, index);
+    player.length = 0;
+    player.next = 0;
+
+    if (sim->directory || sim->corpus) {
+        // the replay is gathered in memory, then written to its file and appended to the corpus in one piece, so workers do not interleave
+        file = open_memstream(&replay, &replay_size);
+    }
+
+    if (file) {
+        recorder = replay_recorder_create(sim_write_replay, file);
+        game_data.recorder = &recorder;
+    }
+
+    game_start(&game_data);
+
+    // while the lines clear the game takes no input, so the player waits for the next tetromino
+    for (steps = 0; steps < sim->max_steps && game_data.state != STATE_OVER; steps++) {
+        input = game_data.state == STATE_PLAYING ? sim->policy(&player, &game_data) : GAME_INPUT_NONE;
+        if (game_step(&game_data, input) & GAME_EVENT_LOCKED) {
+            totals->pieces++;
+            player.length = 0;
+            player.next = 0;
+        }
+    }
+
+    if (file) {
+        // a game stopped at the step limit has not ended its recording yet
+        replay_record_end(&recorder, game_data.ticks, tetrion_hash(&game_data.tetrion));
+        fclose(file);
+    }
+
+    if (replay && sim->directory) {
+        snprintf(path, sizeof(path), "%s/%u.rpl", sim->directory, index);
+        file = fopen(path, "wb");
+        if (file == NULL || fwrite(replay, 1, replay_size, file) != replay_size || fclose(file) != 0) {
+            perror(path);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (replay && sim->corpus) {
+        pthread_mutex_lock(&sim->corpus_lock);
+        if (!corpus_append(sim->corpus, (uint8_t*) replay, replay_size)) {
+            fprintf(stderr, "sim: cannot add game %u to the corpus\n", index);
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_unlock(&sim->corpus_lock);
+    }
+
+    free(replay);
+
+    totals->games++;
+    totals->steps += steps;
+    totals->lines[game_data.tetrion.lines]++;
+}
+
+
+/** Adds up the totals of all workers and prints the rates and the distribution of lines per game. */
+static void sim_report(sim_t* sim, uint16_t threads, double seconds)
+{
+    sim_totals_t sum = { 0 };
+    uint64_t lines_sum = 0;
+    int16_t lines_min = -1;
+    uint16_t lines_max = 0;
+    uint16_t i;
+    uint16_t j;
+
+    for (i = 0; i < threads; i++) {
+        sum.games += sim->totals[i].games;
+        sum.pieces += sim->totals[i].pieces;
+        sum.steps += sim->totals[i].steps;
+        for (j = 0; j < SIM_LINES_MAX; j++)
+            sum.lines[j] += sim->totals[i].lines[j];
+    }
+
+    for (j = 0; j < SIM_LINES_MAX; j++) {
+        if (sum.lines[j]) {
+            lines_sum += (uint64_t) j * sum.lines[j];
+            lines_min = lines_min < 0 ? j : lines_min;
+            lines_max = j;
+        }
+    }
+
+    printf("games        %llu\n", (unsigned long long) sum.games);
+    printf("threads      %u\n", threads);
+    printf("seconds      %.3f\n", seconds);
+    printf("games/sec    %.0f\n", sum.games / seconds);
+    printf("pieces/sec   %.0f\n", sum.pieces / seconds);
+    printf("steps/sec    %.0f\n", sum.steps / seconds);
+    printf("lines        min %d mean %.3f max %u\n", lines_min, sum.games ? (double) lines_sum / sum.games : 0.0, lines_max);
+
+    for (j = 0; j < SIM_LINES_MAX; j++) {
+        if (sum.lines[j]) {
+            printf("  %3u lines  %llu\n", j, (unsigned long long) sum.lines[j]);
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    sim_t sim = { .seed = 1, .max_steps = SIM_MAX_STEPS_DEFAULT, .policy = sim_policy_random, .mode = RANDOMIZER_MODE_BAG };
+    uint32_t games = SIM_GAMES_DEFAULT;
+    uint16_t threads = pool_default_workers();
+    const char* corpus_path = NULL;
+    corpus_writer_t corpus;
+    double start;
+    int option;
+
+    while ((option = getopt(argc, argv, "g:s:t:p:r:m:w:c:")) != -1) {
+        switch (option) {
+            case 'g':
+                games = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                sim.seed = strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                threads = strtoul(optarg, NULL, 0);
+                break;
+            case 'm':
+                sim.max_steps = strtoul(optarg, NULL, 0);
+                break;
+            case 'w':
+                sim.directory = optarg;
+                break;
+            case 'c':
+                corpus_path = optarg;
+                break;
+            case 'p':
+                if (strcmp(optarg, "idle") == 0) {
+                    sim.policy = sim_policy_idle;
+                } else if (strcmp(optarg, "random") == 0) {
+                    sim.policy = sim_policy_random;
+                } else if (strcmp(optarg, "placement") == 0) {
+                    sim.policy = sim_policy_placement;
+                } else {
+                    fprintf(stderr, "sim: unknown policy %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                if (strcmp(optarg, "random") == 0) {
+                    sim.mode = RANDOMIZER_MODE_RANDOM;
+                } else if (strcmp(optarg, "bag") == 0) {
+                    sim.mode = RANDOMIZER_MODE_BAG;
+                } else if (strcmp(optarg, "history") == 0) {
+                    sim.mode = RANDOMIZER_MODE_HISTORY;
+                } else {
+                    fprintf(stderr, "sim: unknown randomizer %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: sim [-g games] [-s seed] [-t threads] [-p idle|random|placement] [-r random|bag|history] [-m max_steps] [-w directory] [-c corpus]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    threads = threads ? threads : 1;
+    sim.totals = aligned_alloc(_Alignof(sim_totals_t), sizeof(sim_totals_t) * threads);
+    memset(sim.totals, 0, sizeof(sim_totals_t) * threads);
+
+    if (corpus_path) {
+        if (!corpus_writer_open(&corpus, corpus_path)) {
+            fprintf(stderr, "sim: cannot open corpus %s\n", corpus_path);
+            return EXIT_FAILURE;
+        }
+        sim.corpus = &corpus;
+        pthread_mutex_init(&sim.corpus_lock, NULL);
+    }
+
+    start = tools_seconds();
+    pool_run(games, threads, sim_game, &sim);
+    sim_report(&sim, threads, tools_seconds() - start);
+
+    if (corpus_path) {
+        corpus_writer_close(&corpus);
+        pthread_mutex_destroy(&sim.corpus_lock);
+    }
+
+    free(sim.totals);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+/**
+    @file   tools.c
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Helpers shared by the headless tools.
+*/
+
+#include <time.h>
+#include "tools.h"
+
+/** The name printed for each replay status. */
+static const char* const tools_replay_status_names[] = {
+    [REPLAY_OK] = "ok",
+    [REPLAY_BAD_FORMAT] = "bad format",
+    [REPLAY_BAD_TETRION] = "recorded on another tetrion size",
+    [REPLAY_MISMATCH] = "MISMATCH"
+};
+
+
+/** Returns the monotonic time in nanoseconds. */
+uint64_t tools_nanoseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+
+/** Returns the monotonic time in seconds. */
+double tools_seconds(void)
+{
+    return tools_nanoseconds() / 1e9;
+}
+
+
+/** Returns the name printed for a replay status. */
+const char* tools_replay_status_name(replay_status_t status)
+{
+    return tools_replay_status_names[status];
+}
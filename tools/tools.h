@@ -0,0 +1,26 @@
+/**
+    @file   tools.h
+    @author Sam Clark (scl113)
+    @date   18 October 2026
+    @brief  Helpers shared by the headless tools.
+*/
+
+#ifndef TOOLS_H
+#define TOOLS_H
+
+#include <stdint.h>
+#include "replay.h"
+
+/** The size of a cache line, which the data kept by each worker is aligned to so workers do not share lines. */
+#define TOOLS_CACHE_LINE 64
+
+/** Returns the monotonic time in nanoseconds. */
+uint64_t tools_nanoseconds(void);
+
+/** Returns the monotonic time in seconds. */
+double tools_seconds(void);
+
+/** Returns the name printed for a replay status. */
+const char* tools_replay_status_name(replay_status_t status);
+
+#endif